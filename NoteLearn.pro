@@ -20,50 +20,27 @@
 #OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
 #SOFTWARE.
 
-QT += core
-QT += gui
-QT += widgets
-QT += multimedia
-
-CONFIG += c++17
-
-# You can make your code fail to compile if it uses deprecated APIs.
-# In order to do so, uncomment the following line.
-DEFINES += QT_DISABLE_DEPRECATED_BEFORE=0x060000    # disables all the APIs deprecated before Qt 6.0.0
-
-SOURCES += \
-    iobuffer.cpp \
-    main.cpp \
-    mainwindow.cpp \
-    note.cpp \
-    staffarea.cpp
-
-HEADERS += \
-    iobuffer.h \
-    mainwindow.h \
-    note.h \
-    noteDefinition.h \
-    staffarea.h
-
-# Default rules for deployment.
-qnx: target.path = /tmp/$${TARGET}/bin
-else: unix:!android: target.path = /opt/$${TARGET}/bin
-!isEmpty(target.path): INSTALLS += target
-
-RESOURCES += \
-    NoteLearn.qrc
-
-DISTFILES += \
-    Screenshot.png \
-    android/AndroidManifest.xml \
-    android/build.gradle \
-    android/gradle.properties \
-    android/gradle/wrapper/gradle-wrapper.jar \
-    android/gradle/wrapper/gradle-wrapper.properties \
-    android/gradlew \
-    android/gradlew.bat \
-    android/res/values/libs.xml
-
-ANDROID_PACKAGE_SOURCE_DIR = $$PWD/android
-
-
+# The App, its DSP core (a library without widgets) and the tools.
+# The benchmarks are built only where Google Benchmark is installed.
+
+TEMPLATE = subdirs
+
+SUBDIRS += \
+    core \
+    app
+
+app.depends = core
+
+!android {
+    SUBDIRS += \
+        replay \
+        daemon \
+        streamclient
+    replay.depends = core
+    daemon.depends = core
+
+    packagesExist(benchmark) {
+        SUBDIRS += bench
+        bench.depends = core
+    }
+}
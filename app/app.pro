@@ -0,0 +1,79 @@
+#MIT License
+
+#Copyright (c) 2022 salvato
+
+#Permission is hereby granted, free of charge, to any person obtaining a copy
+#of this software and associated documentation files (the "Software"), to deal
+#in the Software without restriction, including without limitation the rights
+#to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+#copies of the Software, and to permit persons to whom the Software is
+#furnished to do so, subject to the following conditions:
+
+#The above copyright notice and this permission notice shall be included in all
+#copies or substantial portions of the Software.
+
+#THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+#IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+#FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+#AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+#LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+#OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+#SOFTWARE.
+
+QT += core
+QT += gui
+QT += widgets
+QT += multimedia
+
+CONFIG += c++17
+
+# You can make your code fail to compile if it uses deprecated APIs.
+# In order to do so, uncomment the following line.
+DEFINES += QT_DISABLE_DEPRECATED_BEFORE=0x060000    # disables all the APIs deprecated before Qt 6.0.0
+
+TARGET = NoteLearn
+
+# The detectors, the note tables and the capture buffer
+include(../core/core.pri)
+
+SOURCES += \
+    classroomsession.cpp \
+    classroomwindow.cpp \
+    glyphcache.cpp \
+    latencypanel.cpp \
+    main.cpp \
+    mainwindow.cpp \
+    pullcapture.cpp \
+    staffarea.cpp
+
+HEADERS += \
+    classroomsession.h \
+    classroomwindow.h \
+    glyphcache.h \
+    latencypanel.h \
+    mainwindow.h \
+    pullcapture.h \
+    staffarea.h
+
+# Default rules for deployment.
+qnx: target.path = /tmp/$${TARGET}/bin
+else: unix:!android: target.path = /opt/$${TARGET}/bin
+!isEmpty(target.path): INSTALLS += target
+
+RESOURCES += \
+    ../NoteLearn.qrc
+
+DISTFILES += \
+    ../Screenshot.png \
+    ../android/AndroidManifest.xml \
+    ../android/build.gradle \
+    ../android/gradle.properties \
+    ../android/gradle/wrapper/gradle-wrapper.jar \
+    ../android/gradle/wrapper/gradle-wrapper.properties \
+    ../android/gradlew \
+    ../android/gradlew.bat \
+    ../android/res/values/libs.xml
+
+ANDROID_PACKAGE_SOURCE_DIR = $$PWD/../android
+
+
@@ -0,0 +1,186 @@
+/*
+MIT License
+
+Copyright (c) 2022 salvato
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include "classroomsession.h"
+#include "iobuffer.h"
+#include "dspworker.h"
+#include "pullcapture.h"
+
+#include <QAudioSource>
+
+
+ClassroomSession::ClassroomSession(const QAudioDevice& device,
+                                   const std::vector<Note>& notes,
+                                   QThreadPool* pThreadPool,
+                                   QObject* parent)
+    : QObject(parent)
+    , audioDevice(device)
+    , sampleRate(48000)
+    , sampleSeconds(DspWorker::chunkSeconds)
+    , pAudioSource(nullptr)
+    , randomGenerator(QRandomGenerator::securelySeeded())
+    , startNote(NoteTable::stringStart[0])
+    , endNote(NoteTable::stringStart[0]+NoteTable::nFrets)
+    , currentNote(-1)
+    , nScore(0)
+{
+    // The same capture and analysis window of the main window
+    int nData = int(sampleRate*sampleSeconds)/int(sizeof(int16_t));
+    pBuffer = new IOBuffer(2*nData, this);
+    pPullCapture = new PullCapture(pBuffer, this);
+
+    pDspWorker = new DspWorker(pBuffer, notes, sampleRate, nData);
+    pBuffer->reserve(pDspWorker->maxWindowSamples()+nData);
+    pPullCapture->setReservedSamples(pDspWorker->maxWindowSamples());
+    pDspWorker->setThreadPool(pThreadPool);
+    pDspWorker->setThreshold(DspWorker::defaultThreshold);
+    pDspWorker->setNoiseOffset(DspWorker::sensitivityOffset(DspWorker::defaultSensitivity));
+    connect(pBuffer, SIGNAL(bufferFull()),
+            pDspWorker, SLOT(onBufferFull()),
+            Qt::DirectConnection);
+    connect(pDspWorker, SIGNAL(resultReady()),
+            this, SLOT(onDetectionReady()),
+            Qt::QueuedConnection);
+
+    formatAudio.setSampleRate(sampleRate);
+    formatAudio.setChannelCount(1);
+    formatAudio.setSampleFormat(QAudioFormat::Int16);
+
+    waitTimer.setSingleShot(true);
+    connect(&waitTimer, SIGNAL(timeout()),
+            this, SLOT(onWaitTimerElapsed()));
+}
+
+
+// The pool must have finished the tasks of this session (see stop())
+ClassroomSession::~ClassroomSession() {
+    stop();
+    delete pDspWorker;
+}
+
+
+QString
+ClassroomSession::deviceName() const {
+    return audioDevice.description();
+}
+
+
+void
+ClassroomSession::setNoteRange(int firstNote, int lastNote) {
+    startNote = firstNote;
+    endNote   = lastNote;
+    pDspWorker->setCandidates(startNote, endNote);
+    if(pAudioSource)
+        newTarget();
+}
+
+
+void
+ClassroomSession::setNoiseOffset(double dB) {
+    pDspWorker->setNoiseOffset(dB);
+}
+
+
+bool
+ClassroomSession::start() {
+    stop();
+    pAudioSource = new QAudioSource(audioDevice, formatAudio, this);
+    pBuffer->open(QIODevice::WriteOnly);
+    nScore = 0;
+    emit scoreChanged(nScore);
+    newTarget();
+    pDspWorker->setActive(true);
+    if(!pPullCapture->start(pAudioSource, int(sampleRate*sampleSeconds))) {
+        stop();
+        return false;
+    }
+    return true;
+}
+
+
+// After stop() no new task is given to the pool: the ones still
+// running are waited for by the owner of the pool
+void
+ClassroomSession::stop() {
+    waitTimer.stop();
+    pDspWorker->setActive(false);
+    pPullCapture->stop();
+    if(pAudioSource) {
+        delete pAudioSource;
+        pAudioSource = nullptr;
+    }
+    pBuffer->close();
+}
+
+
+int
+ClassroomSession::score() const {
+    return nScore;
+}
+
+
+int
+ClassroomSession::targetNote() const {
+    return currentNote;
+}
+
+
+double
+ClassroomSession::inputLevel() const {
+    return pDspWorker->inputLevel();
+}
+
+
+void
+ClassroomSession::newTarget() {
+    currentNote = randomGenerator.bounded(startNote, endNote);
+    pDspWorker->setTargetNote(currentNote);
+    emit targetChanged(currentNote);
+}
+
+
+void
+ClassroomSession::onDetectionReady() {
+    PitchEstimate estimate;
+    if(!pDspWorker->takeResult(&estimate))
+        return;
+    if(waitTimer.isActive() || !pAudioSource) // Waiting for the next note
+        return;
+    if(estimate.note == currentNote) {
+        pDspWorker->setActive(false);
+        nScore++;
+        emit scoreChanged(nScore);
+        waitTimer.start(1000);
+    }
+    else {
+        emit missed();
+    }
+}
+
+
+void
+ClassroomSession::onWaitTimerElapsed() {
+    newTarget();
+    pDspWorker->setActive(true);
+}
@@ -0,0 +1,90 @@
+/*
+MIT License
+
+Copyright (c) 2022 salvato
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#pragma once
+
+#include "note.h"
+#include <QObject>
+#include <QAudioDevice>
+#include <QAudioFormat>
+#include <QTimer>
+#include <QRandomGenerator>
+#include <vector>
+
+
+class IOBuffer;
+class DspWorker;
+class PullCapture;
+class QAudioSource;
+class QThreadPool;
+
+
+// One student of the classroom mode: an input device with its own
+// capture buffer, detector, target note and score.
+// The detection runs on the thread pool shared by all the students.
+class ClassroomSession : public QObject
+{
+    Q_OBJECT
+public:
+    ClassroomSession(const QAudioDevice& device,
+                     const std::vector<Note>& notes,
+                     QThreadPool* pThreadPool,
+                     QObject* parent = nullptr);
+    ~ClassroomSession();
+    QString deviceName() const;
+    void setNoteRange(int firstNote, int lastNote);
+    void setNoiseOffset(double dB);
+    bool start();
+    void stop();
+    int score() const;
+    int targetNote() const;
+    double inputLevel() const;
+
+signals:
+    void targetChanged(int note);
+    void scoreChanged(int score);
+    void missed();
+
+private slots:
+    void onDetectionReady();
+    void onWaitTimerElapsed();
+
+protected:
+    void newTarget();
+
+private:
+    QAudioDevice audioDevice;
+    QAudioFormat formatAudio;
+    int sampleRate;
+    double sampleSeconds;
+    IOBuffer* pBuffer;
+    DspWorker* pDspWorker;
+    PullCapture* pPullCapture;
+    QAudioSource* pAudioSource;
+    QRandomGenerator randomGenerator;
+    QTimer waitTimer;
+    int startNote, endNote;
+    int currentNote;
+    int nScore;
+};
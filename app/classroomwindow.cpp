@@ -0,0 +1,205 @@
+/*
+MIT License
+
+Copyright (c) 2022 salvato
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include "classroomwindow.h"
+#include "staffarea.h"
+#include "dspworker.h"
+
+#include <QCloseEvent>
+#include <QComboBox>
+#include <QGridLayout>
+#include <QLabel>
+#include <QMediaDevices>
+#include <QProgressBar>
+#include <QPushButton>
+#include <QScrollArea>
+#include <QThread>
+#include <cmath>
+
+
+ClassroomWindow::ClassroomWindow(int maxStudents)
+    : QWidget()
+    , pStringBox(new QComboBox())
+    , pSensitivityBox(new QComboBox())
+    , pStartButton(new QPushButton("Start"))
+    , pStatusLabel(new QLabel())
+    , nFrets(NoteTable::nFrets)
+{
+    setWindowTitle(tr("Note Learning - Classroom"));
+    notes = equalTemperament(settings.value(QString("A4_Frequency"), QString("440")).toDouble());
+
+    // Every core runs detectors; the pool threads run at the same
+    // priority of the single detection thread of the main window
+    pool.setMaxThreadCount(QThread::idealThreadCount());
+    pool.setThreadPriority(QThread::TimeCriticalPriority);
+
+    QWidget* pStudents = new QWidget();
+    QGridLayout* pGrid = new QGridLayout(pStudents);
+    QList<QAudioDevice> devices = QMediaDevices::audioInputs();
+    int nStudents = int(devices.count());
+    if(maxStudents > 0)
+        nStudents = qMin(nStudents, maxStudents);
+    int nColumns = qMax(1, int(std::ceil(std::sqrt(double(nStudents)))));
+    for(int i=0; i<nStudents; i++) {
+        Panel panel;
+        panel.pSession = new ClassroomSession(devices.at(i), notes, &pool, this);
+        panel.pStaff   = new StaffArea();
+        panel.pScore   = new QLabel("0");
+        panel.pLevel   = new QProgressBar();
+        panel.pLevel->setRange(0, 60);
+        panel.pLevel->setTextVisible(false);
+        panel.pLevel->setMaximumHeight(8);
+
+        QGridLayout* pPanelLayout = new QGridLayout();
+        pPanelLayout->addWidget(new QLabel(panel.pSession->deviceName()), 0, 0, 1, 1);
+        pPanelLayout->addWidget(panel.pScore, 0, 1, 1, 1, Qt::AlignRight);
+        pPanelLayout->addWidget(panel.pStaff, 1, 0, 1, 2);
+        pPanelLayout->addWidget(panel.pLevel, 2, 0, 1, 2);
+        pGrid->addLayout(pPanelLayout, i/nColumns, i%nColumns);
+
+        StaffArea* pStaff = panel.pStaff;
+        QLabel* pScore = panel.pScore;
+        connect(panel.pSession, &ClassroomSession::targetChanged,
+                pStaff, [this, pStaff, pScore](int note) {
+                    pStaff->setNote(notes[note], note);
+                    pScore->setStyleSheet(QString());
+                });
+        connect(panel.pSession, &ClassroomSession::scoreChanged,
+                pScore, [pScore](int score) {
+                    pScore->setNum(score);
+                    pScore->setStyleSheet("QLabel { color: rgb(0, 0, 0); background: rgb(255, 255, 0); }");
+                });
+        connect(panel.pSession, &ClassroomSession::missed,
+                pScore, [pScore]() {
+                    pScore->setStyleSheet("QLabel { color: rgb(255, 255, 255); background: rgb(255, 0, 0); }");
+                });
+        panels.push_back(panel);
+    }
+    QScrollArea* pScrollArea = new QScrollArea();
+    pScrollArea->setWidgetResizable(true);
+    pScrollArea->setWidget(pStudents);
+
+    QStringList strings = {"E", "A", "D", "G", "B", "e"};
+    for(int i=0; i<strings.count(); i++)
+        pStringBox->addItem(strings.at(i));
+    for(int i=1; i<10; i++)
+        pSensitivityBox->addItem(QString("%1").arg(10-i));
+    pSensitivityBox->setCurrentIndex(DspWorker::defaultSensitivity);
+    pStatusLabel->setText(tr("%1 students, %2 detection threads")
+                              .arg(nStudents)
+                              .arg(pool.maxThreadCount()));
+
+    QGridLayout* pMainLayout = new QGridLayout();
+    pMainLayout->addWidget(new QLabel(tr("String")),      0, 0, 1, 1, Qt::AlignRight);
+    pMainLayout->addWidget(pStringBox,                    0, 1, 1, 1);
+    pMainLayout->addWidget(new QLabel(tr("Sensitivity")), 0, 2, 1, 1, Qt::AlignRight);
+    pMainLayout->addWidget(pSensitivityBox,               0, 3, 1, 1);
+    pMainLayout->addWidget(pStartButton,                  0, 4, 1, 1);
+    pMainLayout->addWidget(pScrollArea,                   1, 0, 1, 5);
+    pMainLayout->addWidget(pStatusLabel,                  2, 0, 1, 5);
+    setLayout(pMainLayout);
+
+    connect(pStringBox, SIGNAL(activated(int)),
+            this, SLOT(onStringChanged(int)));
+    connect(pSensitivityBox, SIGNAL(activated(int)),
+            this, SLOT(onSensitivityChanged(int)));
+    connect(pStartButton, SIGNAL(clicked()),
+            this, SLOT(onStartStopPushed()));
+    connect(&levelTimer, SIGNAL(timeout()),
+            this, SLOT(onLevelTimerElapsed()));
+    onStringChanged(0);
+    onSensitivityChanged(pSensitivityBox->currentIndex());
+}
+
+
+ClassroomWindow::~ClassroomWindow() {
+    stopAll();
+}
+
+
+// No session can be deleted while the pool is running its detector
+void
+ClassroomWindow::stopAll() {
+    levelTimer.stop();
+    for(const Panel& panel : panels)
+        panel.pSession->stop();
+    pool.waitForDone();
+}
+
+
+void
+ClassroomWindow::closeEvent(QCloseEvent* event) {
+    stopAll();
+    QWidget::closeEvent(event);
+}
+
+
+void
+ClassroomWindow::onStartStopPushed() {
+    if(pStartButton->text().contains("Stop")) {
+        stopAll();
+        pStartButton->setText("Start");
+        pStringBox->setEnabled(true);
+        return;
+    }
+    int nFailed = 0;
+    for(const Panel& panel : panels) {
+        if(!panel.pSession->start())
+            nFailed++;
+    }
+    if(nFailed > 0)
+        pStatusLabel->setText(tr("%1 devices could not be opened").arg(nFailed));
+    pStartButton->setText("Stop");
+    pStringBox->setDisabled(true);
+    levelTimer.start(100);
+}
+
+
+// The same string ranges and staff octaves of the main window
+void
+ClassroomWindow::onStringChanged(int index) {
+    index = qBound(0, index, NoteTable::nStrings-1);
+    int startNote = NoteTable::stringStart[index];
+    int octaveBase = NoteTable::staffOctaveBase(index);
+    for(const Panel& panel : panels) {
+        panel.pStaff->setOctaveBase(octaveBase);
+        panel.pSession->setNoteRange(startNote, startNote+nFrets);
+    }
+}
+
+
+void
+ClassroomWindow::onSensitivityChanged(int index) {
+    for(const Panel& panel : panels)
+        panel.pSession->setNoiseOffset(DspWorker::sensitivityOffset(index));
+}
+
+
+void
+ClassroomWindow::onLevelTimerElapsed() {
+    for(const Panel& panel : panels) {
+        double dB = 10.0*log10(panel.pSession->inputLevel()+1.0e-12);
+        panel.pLevel->setValue(qBound(0, int(dB+60.5), 60));
+    }
+}
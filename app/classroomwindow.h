@@ -0,0 +1,82 @@
+/*
+MIT License
+
+Copyright (c) 2022 salvato
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#pragma once
+
+#include "note.h"
+#include "classroomsession.h"
+#include <QWidget>
+#include <QThreadPool>
+#include <QTimer>
+#include <QSettings>
+#include <vector>
+
+
+class StaffArea;
+class QComboBox;
+class QLabel;
+class QProgressBar;
+class QPushButton;
+
+
+// Classroom mode: every input device is a student, with a compact
+// staff, score and level. The detectors of all the students share
+// one thread pool, as large as the number of cores.
+class ClassroomWindow : public QWidget
+{
+    Q_OBJECT
+public:
+    explicit ClassroomWindow(int maxStudents = 0);
+    ~ClassroomWindow();
+
+protected:
+    void closeEvent(QCloseEvent* event) override;
+    void stopAll();
+
+private slots:
+    void onStartStopPushed();
+    void onStringChanged(int index);
+    void onSensitivityChanged(int index);
+    void onLevelTimerElapsed();
+
+private:
+    // The widgets of one student
+    struct Panel {
+        ClassroomSession* pSession;
+        StaffArea* pStaff;
+        QLabel* pScore;
+        QProgressBar* pLevel;
+    };
+
+    std::vector<Note> notes;
+    QThreadPool pool;
+    std::vector<Panel> panels;
+    QComboBox* pStringBox;
+    QComboBox* pSensitivityBox;
+    QPushButton* pStartButton;
+    QLabel* pStatusLabel;
+    QTimer levelTimer;
+    QSettings settings;
+    int nFrets;
+};
@@ -0,0 +1,88 @@
+/*
+MIT License
+
+Copyright (c) 2022 salvato
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+#include "glyphcache.h"
+
+#include <QCoreApplication>
+#include <QDebug>
+
+
+// Per rendere trasparente lo sfondo bianco di una immagine
+// tramite linea di comando:
+// $ convert original.png -transparent white transparent.png
+
+// The pixmaps must be released before the application
+GlyphCache&
+GlyphCache::shared() {
+    static GlyphCache* pCache = nullptr;
+    if(!pCache) {
+        pCache = new GlyphCache();
+        qAddPostRoutine([]() {
+            delete pCache;
+            pCache = nullptr;
+        });
+    }
+    return *pCache;
+}
+
+
+GlyphCache::GlyphCache() {
+    const char* files[nGlyphs] = {
+        ":/ChiaveViolino.png",
+        ":/Semibreve.png",
+        ":/Diesis.png"
+    };
+    for(int i=0; i<nGlyphs; i++) {
+        if(!sources[i].load(files[i]))
+            qDebug() << "GlyphCache: unable to load" << files[i];
+        else
+            sources[i] = sources[i].convertToFormat(QImage::Format_ARGB32_Premultiplied);
+    }
+}
+
+
+QPixmap
+GlyphCache::pixmap(Glyph glyph, QSize size, qreal dpr) {
+    Key key(glyph, size.width(), size.height(), dpr);
+    auto it = pixmaps.find(key);
+    if(it != pixmaps.end())
+        return it->second;
+
+    if(int(pixmaps.size()) >= maxEntries)
+        pixmaps.clear();
+    QPixmap scaled;
+    if(!sources[glyph].isNull() && !size.isEmpty()) {
+        scaled = QPixmap::fromImage(sources[glyph].scaled(size*dpr,
+                                                          Qt::IgnoreAspectRatio,
+                                                          Qt::SmoothTransformation));
+        scaled.setDevicePixelRatio(dpr);
+    }
+    pixmaps.emplace(key, scaled);
+    return scaled;
+}
+
+
+int
+GlyphCache::entries() const {
+    return int(pixmaps.size());
+}
@@ -0,0 +1,65 @@
+/*
+MIT License
+
+Copyright (c) 2022 salvato
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+#pragma once
+
+#include <QImage>
+#include <QPixmap>
+#include <QSize>
+#include <map>
+#include <tuple>
+
+
+// The staff glyphs scaled, once, to a given logical size at a given
+// device pixel ratio. The sources are the full resolution images of
+// the resources: every size is a smooth downscale of them, so the
+// paint engine only ever blits pixmaps at their native resolution.
+// One cache, built on first use, serves every staff of the App (the
+// classroom grid shows many of the same size): GUI thread only.
+// The cache is bounded: it is emptied when it holds maxEntries pixmaps
+// (a few resizes of the windows).
+class GlyphCache
+{
+public:
+    enum Glyph {
+        Clef,
+        Semibreve,
+        Sharp,
+        nGlyphs
+    };
+
+    static GlyphCache& shared();
+    QPixmap pixmap(Glyph glyph, QSize size, qreal dpr);
+    int entries() const;
+
+    static const int maxEntries = 8*nGlyphs;
+
+private:
+    GlyphCache();
+    GlyphCache(const GlyphCache&) = delete;
+    GlyphCache& operator=(const GlyphCache&) = delete;
+
+    typedef std::tuple<int, int, int, qreal> Key; // Glyph, width, height, dpr
+    QImage sources[nGlyphs];
+    std::map<Key, QPixmap> pixmaps;
+};
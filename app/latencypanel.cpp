@@ -0,0 +1,79 @@
+/*
+MIT License
+
+Copyright (c) 2022 salvato
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include "latencypanel.h"
+
+#include <QVBoxLayout>
+#include <QFontDatabase>
+
+
+LatencyPanel::LatencyPanel(LatencyStats* pLatencyStats, QWidget* parent)
+    : QWidget(parent, Qt::Tool)
+    , pStats(pLatencyStats)
+    , pReportLabel(new QLabel())
+    , pResetButton(new QPushButton("Reset"))
+{
+    setWindowTitle(tr("Detection Latency (ms)"));
+    pReportLabel->setFont(QFontDatabase::systemFont(QFontDatabase::FixedFont));
+    pReportLabel->setTextInteractionFlags(Qt::TextSelectableByMouse);
+
+    QVBoxLayout* pLayout = new QVBoxLayout();
+    pLayout->addWidget(pReportLabel);
+    pLayout->addWidget(pResetButton, 0, Qt::AlignRight);
+    setLayout(pLayout);
+
+    connect(pResetButton, SIGNAL(clicked()),
+            this, SLOT(onResetPushed()));
+    connect(&refreshTimer, SIGNAL(timeout()),
+            this, SLOT(onRefreshTimerElapsed()));
+    onRefreshTimerElapsed();
+}
+
+
+void
+LatencyPanel::showEvent(QShowEvent* event) {
+    onRefreshTimerElapsed();
+    refreshTimer.start(500);
+    QWidget::showEvent(event);
+}
+
+
+void
+LatencyPanel::hideEvent(QHideEvent* event) {
+    refreshTimer.stop();
+    QWidget::hideEvent(event);
+}
+
+
+void
+LatencyPanel::onRefreshTimerElapsed() {
+    pReportLabel->setText(pStats->report());
+}
+
+
+void
+LatencyPanel::onResetPushed() {
+    pStats->reset();
+    onRefreshTimerElapsed();
+}
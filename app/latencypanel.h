@@ -0,0 +1,55 @@
+/*
+MIT License
+
+Copyright (c) 2022 salvato
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#pragma once
+
+#include "latencystats.h"
+#include <QWidget>
+#include <QLabel>
+#include <QPushButton>
+#include <QTimer>
+
+
+// Debug window with the latency percentiles of every stage,
+// refreshed twice a second while it is visible (F12 toggles it)
+class LatencyPanel : public QWidget
+{
+    Q_OBJECT
+public:
+    explicit LatencyPanel(LatencyStats* pStats, QWidget* parent = nullptr);
+
+protected:
+    void showEvent(QShowEvent* event) Q_DECL_OVERRIDE;
+    void hideEvent(QHideEvent* event) Q_DECL_OVERRIDE;
+
+public slots:
+    void onRefreshTimerElapsed();
+    void onResetPushed();
+
+private:
+    LatencyStats* pStats;
+    QLabel* pReportLabel;
+    QPushButton* pResetButton;
+    QTimer refreshTimer;
+};
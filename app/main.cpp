@@ -23,7 +23,9 @@ SOFTWARE.
 */
 
 #include "mainwindow.h"
+#include "classroomwindow.h"
 #include <QApplication>
+#include <QCommandLineParser>
 
 
 int
@@ -39,6 +41,20 @@ main(int argc, char *argv[]) {
 #endif
     QApplication a(argc, argv);
 
+    QCommandLineParser parser;
+    parser.addHelpOption();
+    parser.addVersionOption();
+    QCommandLineOption classroomOption("classroom", "Classroom mode: every input device is a student.");
+    QCommandLineOption studentsOption("students", "Most students (input devices) in classroom mode.", "n", "0");
+    parser.addOptions({classroomOption, studentsOption});
+    parser.process(a);
+
+    if(parser.isSet(classroomOption)) {
+        ClassroomWindow classroom(parser.value(studentsOption).toInt());
+        classroom.show();
+        return a.exec();
+    }
+
     MainWindow w;
 #ifdef Q_OS_ANDROID
     w.showFullScreen();
@@ -0,0 +1,686 @@
+/*
+MIT License
+
+Copyright (c) 2022 salvato
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include "mainwindow.h"
+#include "acfkernel.h"
+
+#include <QtWidgets>
+#include <QMediaDevices>
+#include <QStandardPaths>
+
+
+// Mio cell 360x717
+// Tablet Acer 1280x752
+
+MainWindow::MainWindow()
+    : QWidget()
+    , sampleRate(48000)
+    , sampleSeconds(DspWorker::chunkSeconds)
+    , pStaffArea(new StaffArea())
+    , pDeviceBox(new QComboBox())
+    , pDetectorBox(new QComboBox())
+    , pRateBox(new QComboBox())
+    , pStartButton(new QPushButton("Start"))
+    , pExitButton(new QPushButton("Exit"))
+    , pSensitivityLabel(new QLabel("   Sensitivity"))
+    , pSensitivityBox(new QComboBox())
+    , pStringLabel(new QLabel("String"))
+    , pStringBox(new QComboBox())
+    , pAudioInput(nullptr)
+    , pRevealButton(new QPushButton("Show Note"))
+    , bRevealChecked(false)
+    , pLowLatencyButton(new QPushButton("Fast"))
+    , bLowLatency(false)
+    , pScoreLabel(new QLabel("Score"))
+    , pScoreEdit(new QLabel(""))
+    , score(0)
+    , pElapsedTimeLabel(new QLabel("Time"))
+    , pElapsedTimeEdit(new QLabel("00:00:00"))
+    , pInputLabel(new QLabel("Input Device"))
+    , pLevelBar(new QProgressBar())
+    , bGateShown(true)
+    , pPullCapture(nullptr)
+    , bPullCapture(true)
+    , chunkSize(sampleRate*sampleSeconds)
+    , pLatencyPanel(nullptr)
+    , bPaintPending(false)
+    , successTime(0)
+    , successCaptureTime(0)
+    , pRandomGenerator(QRandomGenerator::system())
+    , threshold(DspWorker::defaultThreshold) // The gate follows the noise floor above it
+    , updateTime(1000)
+    , timeToWait(1000)
+    , nFrets(NoteTable::nFrets) // Only first 12 Frets (22 on Guitars Like Fender Stratocaster)
+{
+    pRandomGenerator->securelySeeded();
+    pRevealButton->setCheckable(true);
+    pLowLatencyButton->setCheckable(true);
+    setWindowTitle(tr("Note Learning"));
+
+    // Get the last Saved Settings
+    getSettings();
+
+    // Notes definition (equal temperament from the A4 reference)
+    notes = equalTemperament(a4Frequency);
+
+    // Setup the styles
+    sNormalStyle  = pScoreEdit->styleSheet();
+    sErrorStyle   = "QLabel { color: rgb(255, 255, 255); background: rgb(255, 0, 0); selection-background-color: rgb(128, 128, 255); }";
+    sDarkStyle    = "QLabel { color: rgb(255, 255, 255); background: rgb(0, 0, 0); selection-background-color: rgb(128, 128, 255); }";
+    sSuccessStyle = "QLabel { color: rgb(0, 0, 0); background: rgb(255, 255, 0); selection-background-color: rgb(128, 128, 255); }";
+
+    // Setup Audio Data Buffer
+    nData = chunkSize/int(sizeof(int16_t));
+    pBuffer = new IOBuffer(2*nData, this);
+    pBuffer->setLatencyStats(&latencyStats);
+    pPullCapture = new PullCapture(pBuffer, this);
+
+    // The Pitch Detection runs on its own thread
+    pDspWorker = new DspWorker(pBuffer, notes, sampleRate, nData);
+    // The ring keeps room for the largest write past the longest
+    // window, so the reader is not overwritten while processing
+    pBuffer->reserve(pDspWorker->maxWindowSamples()+nData);
+    pPullCapture->setReservedSamples(pDspWorker->maxWindowSamples());
+    pDspWorker->setLatencyStats(&latencyStats);
+    pDspWorker->moveToThread(&dspThread);
+    connect(&dspThread, SIGNAL(finished()),
+            pDspWorker, SLOT(deleteLater()));
+    connect(pBuffer, SIGNAL(bufferFull()),
+            pDspWorker, SLOT(onBufferFull()),
+            Qt::DirectConnection);
+    connect(pDspWorker, SIGNAL(resultReady()),
+            this, SLOT(onDetectionReady()));
+    dspThread.start(QThread::TimeCriticalPriority);
+
+    // Audio Devices ComboBox handling
+    // Fills the ComboBox with a list of audio devices that support AudioInput
+    deviceInfo = QMediaDevices::audioInputs();
+    for(int i=0; i<deviceInfo.count(); i++) {
+        pDeviceBox->addItem(deviceInfo.at(i).description(), QVariant::fromValue(deviceInfo.at(i)));
+    }
+    // if still connected, use the previous saved device
+    int index = pDeviceBox->findText(sInputDevice);
+    if(index == -1) index = 0;
+    pDeviceBox->setCurrentIndex(index);
+
+    // Detector ComboBox handling
+    for(int i=0; i<pDspWorker->detectorCount(); i++)
+        pDetectorBox->addItem(pDspWorker->detectorName(i));
+    pDetectorBox->setCurrentIndex(detectorIndex);
+    onDetectorChanged(detectorIndex);
+
+    // Analysis Rate ComboBox handling (decimation factors 1, 2 and 4)
+    for(int i=0; i<3; i++)
+        pRateBox->addItem(QString("%1 kHz").arg(sampleRate/(1000 << i)));
+    pRateBox->setCurrentIndex(rateIndex);
+    onRateChanged(rateIndex);
+
+    // Sensitivity ComboBox handling
+    pSensitivityLabel->setAlignment(Qt::AlignRight|Qt::AlignVCenter);
+    for(int i=1; i<10; i++)
+        pSensitivityBox->addItem(QString("%1").arg(10-i));
+    pSensitivityBox->setCurrentIndex(sensitivityIndex);
+    pSensitivityBox->setToolTip(tr("Higher values detect softer notes over the room noise"));
+    pDspWorker->setThreshold(threshold);
+    onSensitivityChanged(sensitivityIndex);
+
+    // Starting Octave ComboBox handling
+    pStringLabel->setAlignment(Qt::AlignRight|Qt::AlignVCenter);
+    strings = {"E", "A", "D", "G", "B", "e"};
+    pStringBox->addItems(strings);
+    pStringBox->setCurrentIndex(currentString);
+    onStringChanged(currentString);
+
+    pRevealButton->setChecked(bRevealChecked);
+    pStaffArea->setRevealNote(bRevealChecked);
+
+    pLowLatencyButton->setChecked(bLowLatency);
+    pDspWorker->setLowLatency(bLowLatency);
+
+    pScoreLabel->setAlignment(Qt::AlignRight|Qt::AlignVCenter);
+    pScoreEdit->setAlignment(Qt::AlignHCenter|Qt::AlignVCenter);
+    pScoreEdit->setNum(score);
+
+    elapsedTime = QTime(0, 0, 0, 0);
+    pElapsedTimeLabel->setAlignment(Qt::AlignRight|Qt::AlignVCenter);
+    pElapsedTimeEdit->setAlignment(Qt::AlignHCenter|Qt::AlignVCenter);
+    pElapsedTimeEdit->setText(elapsedTime.toString());
+
+    // Input Level Meter (-60dB to 0dB Full Scale)
+    pLevelBar->setRange(0, 60);
+    pLevelBar->setValue(0);
+    pLevelBar->setTextVisible(false);
+    pLevelBar->setFixedHeight(8);
+
+    // MainWindow Layout
+    QGridLayout *mainLayout = new QGridLayout;
+
+    QWidget *lineB = new QWidget;
+    lineB->setFixedHeight(2);
+    lineB->setSizePolicy(QSizePolicy::Expanding, QSizePolicy::Fixed);
+    lineB->setStyleSheet(QString("background-color: rgb(192, 192, 192);"));
+
+    mainLayout->addWidget(pInputLabel,       0, 0, 1, 1, Qt::AlignRight);
+    mainLayout->addWidget(pDeviceBox,        0, 1, 1, 3);
+    mainLayout->addWidget(pDetectorBox,      0, 4, 1, 2);
+
+    mainLayout->addWidget(pStaffArea,        1, 0, 3, 6);
+
+    mainLayout->addWidget(pStringLabel,      4, 0, 1, 1, Qt::AlignHCenter|Qt::AlignBottom);
+    mainLayout->addWidget(pScoreLabel,       4, 2, 1, 2, Qt::AlignHCenter);
+    mainLayout->addWidget(pElapsedTimeLabel, 4, 4, 1, 2, Qt::AlignHCenter|Qt::AlignBottom);
+
+    mainLayout->addWidget(pStringBox,        5, 0, 1, 1, Qt::AlignHCenter|Qt::AlignTop);
+    mainLayout->addWidget(pScoreEdit,        5, 2, 1, 2);
+    mainLayout->addWidget(pElapsedTimeEdit,  5, 4, 1, 2, Qt::AlignHCenter|Qt::AlignTop);
+
+    mainLayout->addWidget(pRevealButton,     6, 0, 1, 1);
+    mainLayout->addWidget(pLowLatencyButton, 6, 1, 1, 1);
+    mainLayout->addWidget(pSensitivityLabel, 6, 2, 1, 2, Qt::AlignRight);
+    mainLayout->addWidget(pSensitivityBox,   6, 4, 1, 2, Qt::AlignLeft);
+
+    mainLayout->addWidget(pLevelBar,         7, 0, 1, 6);
+
+    mainLayout->addWidget(lineB,             8, 0, 1, 6);
+
+    mainLayout->addWidget(pExitButton,       9, 0, 1, 1);
+    mainLayout->addWidget(pRateBox,          9, 2, 1, 2, Qt::AlignHCenter);
+    mainLayout->addWidget(pStartButton,      9, 4, 1, 2);
+
+    setLayout(mainLayout);
+
+    // UI Message handlers
+    connect(pExitButton, SIGNAL(clicked()),
+            this, SLOT(onExitPushed()));
+    connect(pStartButton, SIGNAL(clicked()),
+            this, SLOT(onStartStopPushed()));
+    connect(pDeviceBox, SIGNAL(activated(int)),
+            this, SLOT(onInputDeviceChanged(int)));
+    connect(pSensitivityBox, SIGNAL(activated(int)),
+            this, SLOT(onSensitivityChanged(int)));
+    connect(pStringBox, SIGNAL(activated(int)),
+            this, SLOT(onStringChanged(int)));
+    connect(pDetectorBox, SIGNAL(activated(int)),
+            this, SLOT(onDetectorChanged(int)));
+    connect(pRateBox, SIGNAL(activated(int)),
+            this, SLOT(onRateChanged(int)));
+    connect(pRevealButton, SIGNAL(clicked()),
+            this, SLOT(OnRevealCheckBoxStateChanged()));
+    connect(pLowLatencyButton, SIGNAL(clicked()),
+            this, SLOT(onLowLatencyStateChanged()));
+
+    // Create the QAudioInput object that represents an input channel.
+    // It enables the selection of the physical input device to be used.
+    // It allows muting the channel and changing the channel's volume.
+    pAudioInput = new QAudioInput(deviceInfo.at(pDeviceBox->currentIndex()), this);
+
+    // Define requested Audio Format
+    formatAudio.setSampleRate(sampleRate);
+    formatAudio.setChannelCount(1);
+    formatAudio.setSampleFormat(QAudioFormat::Int16);
+
+    // Create the Audio Input Source with the specified QAudioDevice
+    // also sending the QAudioFormat to be used for the acquisition.
+    pAudioSource = new  QAudioSource(deviceInfo.at(pDeviceBox->currentIndex()), formatAudio);
+    pAudioSource->setBufferSize(audioBufferBytes());
+
+    // Setup of the timer for update the Running Time
+    updateTimer.setTimerType(Qt::PreciseTimer);
+    connect(&updateTimer, SIGNAL(timeout()),
+            this, SLOT(onUpdateTimerElapsed()));
+    connect(&waitTimer, SIGNAL(timeout()),
+            this, SLOT(onWaitTimerElapsed()));
+    connect(&levelTimer, SIGNAL(timeout()),
+            this, SLOT(onLevelTimerElapsed()));
+
+    // Latency debug panel (F12) and repaint time of the score
+    pLatencyPanel = new LatencyPanel(&latencyStats, this);
+    QShortcut* pLatencyShortcut = new QShortcut(QKeySequence(Qt::Key_F12), this);
+    connect(pLatencyShortcut, SIGNAL(activated()),
+            this, SLOT(onLatencyPanelToggled()));
+    pScoreEdit->installEventFilter(this);
+}
+
+
+void
+MainWindow::closeEvent(QCloseEvent *event) {
+    updateTimer.stop();
+    waitTimer.stop();
+    levelTimer.stop();
+    if(pAudioInput) {
+        pPullCapture->stop();
+        pAudioSource->stop();
+        delete pAudioInput;
+    }
+    saveSettings();
+    pDspWorker->setActive(false);
+    saveNoiseFloor();
+    dspThread.quit();
+    dspThread.wait();
+    dumpLatency();
+    if(pBuffer) {
+        pBuffer->close();
+        delete pBuffer;
+        pBuffer = nullptr;
+    }
+    QWidget::closeEvent(event);// Propagate the event
+}
+
+
+void
+MainWindow::getSettings() {
+    restoreGeometry(settings.value(QString("MainWindow_Dialog")).toByteArray());
+    sInputDevice     = settings.value(QString("Input_Device"), QString("default")).toString();
+    sensitivityIndex = settings.value(QString("Sensitivity"),  QString::number(DspWorker::defaultSensitivity)).toInt();
+    currentString    = settings.value(QString("String"),       QString("0")).toInt();
+    bRevealChecked   = settings.value(QString("Reveal"),       QString("true")).toBool();
+    detectorIndex    = settings.value(QString("Detector"),     QString("0")).toInt();
+    bLowLatency      = settings.value(QString("LowLatency"),   QString("false")).toBool();
+    rateIndex        = settings.value(QString("Decimation"),   QString("0")).toInt();
+    a4Frequency      = settings.value(QString("A4_Frequency"), QString("440")).toDouble();
+    bPullCapture     = settings.value(QString("Pull_Capture"), QString("true")).toBool();
+    if(a4Frequency < 400.0 || a4Frequency > 480.0)
+        a4Frequency = NoteTable::defaultA4Frequency;
+}
+
+
+void
+MainWindow::saveSettings() {
+    settings.setValue(QString("MainWindow_Dialog"), saveGeometry());
+    settings.setValue(QString("Input_Device"), pDeviceBox->currentText());
+    settings.setValue(QString("Sensitivity"),  pSensitivityBox->currentIndex());
+    settings.setValue(QString("String"),       pStringBox->currentIndex());
+    settings.setValue(QString("Reveal"),       pRevealButton->isChecked());
+    settings.setValue(QString("Detector"),     pDetectorBox->currentIndex());
+    settings.setValue(QString("LowLatency"),   pLowLatencyButton->isChecked());
+    settings.setValue(QString("Decimation"),   pRateBox->currentIndex());
+    settings.setValue(QString("A4_Frequency"), a4Frequency);
+    settings.setValue(QString("Pull_Capture"), bPullCapture);
+}
+
+
+// When resizeEvent() is called, the widget already has its new geometry.
+void
+MainWindow::resizeEvent(QResizeEvent *event) {
+    buildFontSizes();
+    event->setAccepted(true);
+}
+
+
+void
+MainWindow::buildFontSizes() {
+    QFont font = pScoreEdit->font();
+    int iFontSize = qMin(width()/9, height());
+    font.setPixelSize(iFontSize);
+    pScoreEdit->setFont(font);
+
+    iFontSize = qMin(width()/30, height());
+    font.setPixelSize(iFontSize);
+
+    pScoreLabel->setFont(font);
+    pStringLabel->setFont(font);
+    pStringBox->setFont(font);
+    pElapsedTimeLabel->setFont(font);
+    pElapsedTimeEdit->setFont(font);
+    pSensitivityLabel->setFont(font);
+    pSensitivityBox->setFont(font);
+    pRevealButton->setFont(font);
+    pLowLatencyButton->setFont(font);
+    pInputLabel->setFont(font);
+    pDetectorBox->setFont(font);
+    pRateBox->setFont(font);
+    pStartButton->setFont(font);
+    pExitButton->setFont(font);
+}
+
+
+void
+MainWindow::onStartStopPushed() {
+    if(pStartButton->text().contains("Stop")) {
+        updateTimer.stop();
+        pStartButton->setText("Start");
+        pDspWorker->setActive(false);
+        levelTimer.stop();
+        saveNoiseFloor();
+        pLevelBar->setValue(0);
+        if(bPullCapture)
+            pPullCapture->stop();
+        else
+            pAudioSource->stop();
+        pBuffer->close();
+        pInputLabel->setEnabled(true);
+        pDeviceBox->setEnabled(true);
+        pScoreEdit->setStyleSheet(sNormalStyle);
+        return;
+    }
+    pStartButton->setText("Stop");
+    pInputLabel->setDisabled(true);
+    pDeviceBox->setDisabled(true);
+    pBuffer->open(QIODevice::WriteOnly);
+    newTarget();
+    score = 0;
+    pScoreEdit->setNum(score);
+    pDspWorker->setNoiseFloor(settings.value(noiseFloorKey(), 0.0).toDouble());
+    pDspWorker->setActive(true);
+    if(bPullCapture) { // The detector runs once per hop
+        pPullCapture->start(pAudioSource, audioBufferBytes());
+    }
+    else {
+        pAudioSource->setBufferSize(audioBufferBytes());
+        pAudioSource->start(pBuffer);
+    }
+    startTime = QTime::currentTime();
+    elapsedTime = QTime(0, 0, 0, 0);
+    updateTimer.start(updateTime);
+    levelTimer.start(50);
+}
+
+
+// Runs on the UI thread: only the score and the staff are updated here
+void
+MainWindow::onDetectionReady() {
+    PitchEstimate estimate;
+    if(!pDspWorker->takeResult(&estimate))
+        return;
+    int64_t now = LatencyStats::now();
+    latencyStats.record(LatencyStats::Deliver, now-estimate.publishTime);
+    if(waitTimer.isActive()) // Waiting for the next note
+        return;
+    bool bFound = estimate.nNotes == int(currentChord.size()) &&
+                  std::equal(currentChord.begin(), currentChord.end(), estimate.notes);
+    if(bFound) {
+        pDspWorker->setActive(false);
+        waitTimer.start(timeToWait);
+        elapsedTime = elapsedTime.addSecs(updateTimer.remainingTime()/double(updateTime));
+        startTime = QTime::currentTime();
+        updateTimer.stop();
+        score++;
+        pScoreEdit->setNum(score);
+        pScoreEdit->setStyleSheet(sSuccessStyle);
+        pStaffArea->setNote(notes[0], -1);
+        bPaintPending = true;
+        successTime = now;
+        successCaptureTime = estimate.captureTime;
+    }
+    else {
+        pScoreEdit->setStyleSheet(sErrorStyle);
+    }
+}
+
+
+void
+MainWindow::onInputDeviceChanged(int index) {
+    Q_UNUSED(index)
+    if(pAudioInput) delete pAudioInput;
+    pAudioInput = new QAudioInput(deviceInfo.at(pDeviceBox->currentIndex()), this);
+    pAudioSource = new  QAudioSource(deviceInfo.at(pDeviceBox->currentIndex()), formatAudio);
+    pAudioSource->setBufferSize(audioBufferBytes());
+}
+
+
+// The sensitivity is the margin over the noise floor of the device
+void
+MainWindow::onSensitivityChanged(int index) {
+    pDspWorker->setNoiseOffset(DspWorker::sensitivityOffset(index));
+}
+
+
+// The noise floor learned on every device is kept between sessions
+QString
+MainWindow::noiseFloorKey() const {
+    QString sDevice = pDeviceBox->currentText();
+    sDevice.replace('/', '_').replace('\\', '_');
+    return QString("Noise_Floor/")+sDevice;
+}
+
+
+void
+MainWindow::saveNoiseFloor() {
+    if(pDspWorker->noiseFloor() > 0.0)
+        settings.setValue(noiseFloorKey(), pDspWorker->noiseFloor());
+}
+
+
+void
+MainWindow::onDetectorChanged(int index) {
+    detectorIndex = index;
+    pDspWorker->setDetector(detectorIndex);
+    if(pStartButton->text() == QString("Stop")) // Chords may come or go
+        newTarget();
+}
+
+
+// The detectors work on the signal decimated by 2^index
+void
+MainWindow::onRateChanged(int index) {
+    rateIndex = qBound(0, index, 2);
+    pDspWorker->setDecimation(1 << rateIndex);
+}
+
+
+// nFrets Frets Guitars
+void
+MainWindow::onStringChanged(int index) {
+    currentString = index;
+    switch (currentString) {
+        case 0: // E String
+            startNote = NoteTable::stringStart[0]; // E#2
+            endNote   = startNote+nFrets;          // E3
+            break;
+        case 1: // A String
+            startNote = NoteTable::stringStart[1]; // A#2
+            endNote   = startNote+nFrets;          // A3
+            break;
+        case 2: // D String
+            startNote = NoteTable::stringStart[2]; // D#3
+            endNote   = startNote+nFrets;          // D4
+            break;
+        case 3: // G String
+            startNote = NoteTable::stringStart[3]; // G#3
+            endNote   = startNote+nFrets;          // G4
+            break;
+        case 4: // B String
+            startNote = NoteTable::stringStart[4]; // C4
+            endNote   = startNote+nFrets;          // B4
+            break;
+        case 5: // e String
+            startNote = NoteTable::stringStart[5]; // E#4
+            endNote   = startNote+nFrets;          // E5
+            break;
+        default: // Never Executed !!!
+            exit(EXIT_FAILURE);
+    }
+    pStaffArea->setOctaveBase(NoteTable::staffOctaveBase(currentString));
+    pDspWorker->setCandidates(startNote, endNote);
+    if(pStartButton->text() == QString("Stop")) { // We are Running: Generate a New Note
+        newTarget();
+    }
+
+}
+
+
+void
+MainWindow::OnRevealCheckBoxStateChanged() {
+    bRevealChecked = pRevealButton->isChecked();
+    pStaffArea->setRevealNote(bRevealChecked);
+    pStaffArea->update();
+}
+
+
+// The audio device buffer size can only be changed while stopped:
+// it is applied at the next Start
+void
+MainWindow::onLowLatencyStateChanged() {
+    bLowLatency = pLowLatencyButton->isChecked();
+    pDspWorker->setLowLatency(bLowLatency);
+    if(pStartButton->text() == QString("Stop"))
+        newTarget();
+}
+
+
+// In low latency mode the audio device delivers 10ms chunks
+// instead of half of the original 0.3s analysis window.
+// In pull mode this is the hop of the detector.
+int
+MainWindow::audioBufferBytes() const {
+    if(bLowLatency)
+        return int(sizeof(int16_t))*sampleRate/100;
+    return int(sampleRate*sampleSeconds);
+}
+
+
+void
+MainWindow::setCurrentNote(int note) {
+    currentNote = note;
+    currentChord.assign(1, currentNote);
+    pStaffArea->setNote(notes[currentNote], currentNote);
+    pDspWorker->setTargetNote(currentNote);
+}
+
+
+// A dyad (third or fifth) or a triad (major or minor) on rootNote
+void
+MainWindow::setCurrentChord(int rootNote) {
+    currentNote = rootNote;
+    int third = rootNote+pRandomGenerator->bounded(3, 5);
+    int fifth = rootNote+7;
+    switch(pRandomGenerator->bounded(3)) {
+        case 0:
+            currentChord = {rootNote, third};
+            break;
+        case 1:
+            currentChord = {rootNote, fifth};
+            break;
+        default:
+            currentChord = {rootNote, third, fifth};
+            break;
+    }
+    pStaffArea->setChord(notes, currentChord);
+    pDspWorker->setTargetNote(currentNote);
+}
+
+
+// The low latency detector only hears single notes
+bool
+MainWindow::isChordMode() const {
+    return !bLowLatency && pDspWorker->detectorPolyphony(detectorIndex) > 1;
+}
+
+
+// All the notes of a chord are within the range of the selected string
+void
+MainWindow::newTarget() {
+    if(isChordMode())
+        setCurrentChord(pRandomGenerator->bounded(startNote, endNote-7));
+    else
+        setCurrentNote(pRandomGenerator->bounded(startNote, endNote));
+}
+
+
+void
+MainWindow::onUpdateTimerElapsed() {
+#ifndef Q_OS_ANDROID
+    int mSecs = startTime.msecsTo(QTime::currentTime());
+    elapsedTime = elapsedTime.addSecs(mSecs/double(updateTime));
+    startTime = QTime::currentTime();
+#else
+    elapsedTime = elapsedTime.addSecs(1);
+#endif
+    pElapsedTimeEdit->setText(elapsedTime.toString());
+}
+
+
+void
+MainWindow::onWaitTimerElapsed() {
+    waitTimer.stop();
+    newTarget();
+    pDspWorker->setActive(true);
+    updateTimer.start(updateTime);
+}
+
+
+// The Level Meter is green while the detectors are running
+void
+MainWindow::onLevelTimerElapsed() {
+    double dB = 10.0*log10(pDspWorker->inputLevel()+1.0e-12);
+    pLevelBar->setValue(qBound(0, int(dB+60.5), 60));
+    bool bGateOpen = pDspWorker->isGateOpen();
+    if(bGateOpen != bGateShown) {
+        bGateShown = bGateOpen;
+        pLevelBar->setStyleSheet(bGateOpen ? "QProgressBar::chunk { background: rgb(0, 192, 0); }"
+                                           : "QProgressBar::chunk { background: rgb(128, 128, 128); }");
+    }
+}
+
+
+// The success (yellow) score is on screen when its paint event arrives
+bool
+MainWindow::eventFilter(QObject* pObject, QEvent* pEvent) {
+    if(bPaintPending && pObject == pScoreEdit && pEvent->type() == QEvent::Paint) {
+        bPaintPending = false;
+        int64_t now = LatencyStats::now();
+        latencyStats.record(LatencyStats::Paint, now-successTime);
+        latencyStats.record(LatencyStats::EndToEnd, now-successCaptureTime);
+    }
+    return QWidget::eventFilter(pObject, pEvent);
+}
+
+
+void
+MainWindow::onLatencyPanelToggled() {
+    pLatencyPanel->setVisible(!pLatencyPanel->isVisible());
+}
+
+
+// The timings of the session are written in the application data folder,
+// with the device and the detector used, to compare devices and releases
+void
+MainWindow::dumpLatency() {
+    if(latencyStats.histogram(LatencyStats::Detect).count() == 0)
+        return;
+    QString sPath = QStandardPaths::writableLocation(QStandardPaths::AppLocalDataLocation);
+    QDir().mkpath(sPath);
+    QString sFileName = sPath+"/latency.txt";
+    QString sHeader = QString("%1\nDevice: %2\nDetector: %3\nRate: %4\nFast: %5\nCapture: %6\nKernels: %7")
+                          .arg(QDateTime::currentDateTime().toString(Qt::ISODate),
+                               pDeviceBox->currentText(),
+                               pDetectorBox->currentText(),
+                               pRateBox->currentText(),
+                               bLowLatency ? QString("yes") : QString("no"),
+                               bPullCapture ? QString("pull, block %1 bytes, device buffer %2 bytes, %3 bursts")
+                                                  .arg(pPullCapture->blockBytes())
+                                                  .arg(pPullCapture->deviceBufferBytes())
+                                                  .arg(pPullCapture->bursts())
+                                            : QString("push"),
+                               QString("%1, %2").arg(QString::fromLatin1(acfKernelName()),
+                                                     QString::fromLatin1(acfInt16KernelName())));
+    if(latencyStats.dump(sFileName, sHeader))
+        qDebug() << "Latency statistics written to" << sFileName;
+}
+
+
+void
+MainWindow::onExitPushed() {
+    close();
+}
@@ -28,6 +28,10 @@ SOFTWARE.
 #include "staffarea.h"
 #include "note.h"
 #include "iobuffer.h"
+#include "dspworker.h"
+#include "latencystats.h"
+#include "latencypanel.h"
+#include "pullcapture.h"
 #include <QWidget>
 #include <QComboBox>
 #include <QLabel>
@@ -41,6 +45,8 @@ SOFTWARE.
 #include <QCheckBox>
 #include <QLineEdit>
 #include <QDateTime>
+#include <QThread>
+#include <QProgressBar>
 
 
 class MainWindow : public QWidget
@@ -53,20 +59,34 @@ public:
 protected:
     void closeEvent(QCloseEvent *event) Q_DECL_OVERRIDE;
     void resizeEvent(QResizeEvent *event) Q_DECL_OVERRIDE;
+    bool eventFilter(QObject* pObject, QEvent* pEvent) Q_DECL_OVERRIDE;
+    void dumpLatency();
     void saveSettings();
     void getSettings();
     void buildFontSizes();
+    void setCurrentNote(int note);
+    void setCurrentChord(int rootNote);
+    void newTarget();
+    bool isChordMode() const;
+    int audioBufferBytes() const;
+    QString noiseFloorKey() const;
+    void saveNoiseFloor();
 
 public slots:
     void onInputDeviceChanged(int index);
     void onSensitivityChanged(int index);
     void onStringChanged(int index);
+    void onDetectorChanged(int index);
+    void onRateChanged(int index);
     void onStartStopPushed();
     void OnRevealCheckBoxStateChanged();
-    void OnBufferFull();
+    void onLowLatencyStateChanged();
+    void onDetectionReady();
     void onUpdateTimerElapsed();
     void onWaitTimerElapsed();
+    void onLevelTimerElapsed();
     void onExitPushed();
+    void onLatencyPanelToggled();
 
 private:
     QSettings settings;
@@ -77,6 +97,8 @@ private:
     double sampleSeconds;
     StaffArea* pStaffArea;
     QComboBox* pDeviceBox;
+    QComboBox* pDetectorBox;
+    QComboBox* pRateBox;
     QPushButton* pStartButton;
     QPushButton* pExitButton;
     QLabel* pSensitivityLabel;
@@ -87,6 +109,8 @@ private:
     QList<QString> strings;
     QPushButton* pRevealButton;
     bool bRevealChecked;
+    QPushButton* pLowLatencyButton;
+    bool bLowLatency;
     QLabel* pScoreLabel;
     QLabel* pScoreEdit;
     int score;
@@ -94,29 +118,38 @@ private:
     QLabel* pElapsedTimeEdit;
     QTime elapsedTime;
     QLabel* pInputLabel;
+    QProgressBar* pLevelBar;
+    bool bGateShown;
     IOBuffer* pBuffer;
-    char* pData;
+    PullCapture* pPullCapture;
+    bool bPullCapture;
     int chunkSize;
     int nData;
-    int16_t* dataPointer;
     std::vector<Note> notes;
-    int Lags;
-    int ACORSLENGTH;
-    int* acorLags;
-    double* R;
+    DspWorker* pDspWorker;
+    QThread dspThread;
+    LatencyStats latencyStats;
+    LatencyPanel* pLatencyPanel;
+    bool bPaintPending;
+    int64_t successTime;
+    int64_t successCaptureTime;
     QRandomGenerator* pRandomGenerator;
     double threshold;
     QString sInputDevice;
     QTimer testTimer;
     QTimer updateTimer;
     QTimer waitTimer;
+    QTimer levelTimer;
     int updateTime;
     int timeToWait;
     int currentNote;
-    int nDetections;
+    std::vector<int> currentChord; // Lowest note first
     int sensitivityIndex;
     int octaveIndex;
     int stringIndex;
+    int detectorIndex;
+    int rateIndex;
+    double a4Frequency;
     int currentString;
     int startNote, endNote, nFrets;
     QTime startTime;
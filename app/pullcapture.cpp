@@ -0,0 +1,169 @@
+/*
+MIT License
+
+Copyright (c) 2022 salvato
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include "pullcapture.h"
+#include "iobuffer.h"
+
+#include <QAudioSource>
+#include <QIODevice>
+#include <algorithm>
+
+
+namespace {
+// Reads without bursts before halving the block
+const int quietReadsToShrink = 50;
+// Device buffer as a multiple of the hop at the first start
+const int deviceHops = 4;
+} // namespace
+
+
+PullCapture::PullCapture(IOBuffer* pIOBuffer, QObject* parent)
+    : QObject(parent)
+    , pBuffer(pIOBuffer)
+    , pSource(nullptr)
+    , pDevice(nullptr)
+    , nFill(0)
+    , hop(0)
+    , blockSize(0)
+    , maxBlockSize(0)
+    , nReserved(0)
+    , deviceBytes(0)
+    , nQuietReads(0)
+    , nBursts(0)
+{
+}
+
+
+// The samples of the ring read in place by the detector
+// (its longest window): must be set before start()
+void
+PullCapture::setReservedSamples(int nSamples) {
+    nReserved = nSamples;
+}
+
+
+// hopBytes is rounded to whole samples. The block memory for
+// the largest block is allocated here and never again while running.
+bool
+PullCapture::start(QAudioSource* pAudioSource, int hopBytes) {
+    stop();
+    hopBytes = std::max(int(sizeof(int16_t)), hopBytes & ~int(sizeof(int16_t)-1));
+    if(hopBytes != hop) {
+        hop = hopBytes;
+        deviceBytes = deviceHops*hop;
+        block.assign(size_t(maxHops)*size_t(hop), 0);
+    }
+    // The largest block (a power of two hops) leaves
+    // the reserved samples of the ring untouched
+    int freeBytes = (pBuffer->capacity()-nReserved)*int(sizeof(int16_t));
+    maxBlockSize = hop;
+    while(2*maxBlockSize <= std::min(maxHops*hop, freeBytes))
+        maxBlockSize *= 2;
+    blockSize   = hop;
+    nFill       = 0;
+    nQuietReads = 0;
+    pSource = pAudioSource;
+    pSource->setBufferSize(deviceBytes);
+    connect(pSource, SIGNAL(stateChanged(QAudio::State)),
+            this, SLOT(onStateChanged(QAudio::State)));
+    pDevice = pSource->start();
+    if(!pDevice) {
+        stop();
+        return false;
+    }
+    connect(pDevice, SIGNAL(readyRead()),
+            this, SLOT(onReadyRead()));
+    return true;
+}
+
+
+void
+PullCapture::stop() {
+    if(pDevice)
+        disconnect(pDevice, nullptr, this, nullptr);
+    if(pSource) {
+        disconnect(pSource, nullptr, this, nullptr);
+        pSource->stop();
+    }
+    pDevice = nullptr;
+    pSource = nullptr;
+}
+
+
+int
+PullCapture::blockBytes() const {
+    return blockSize;
+}
+
+
+int
+PullCapture::deviceBufferBytes() const {
+    return deviceBytes;
+}
+
+
+// Reads that brought more than two blocks
+quint64
+PullCapture::bursts() const {
+    return nBursts;
+}
+
+
+void
+PullCapture::onReadyRead() {
+    int nBlocks = 0;
+    for(;;) {
+        qint64 nRead = pDevice->read(block.data()+nFill, blockSize-nFill);
+        if(nRead <= 0)
+            break;
+        nFill += int(nRead);
+        if(nFill == blockSize) {
+            pBuffer->write(block.data(), blockSize);
+            nFill = 0;
+            nBlocks++;
+        }
+    }
+    // The block follows the granularity of the backend:
+    // one wake up of the detector per read is enough
+    if(nBlocks > 2) {
+        nBursts++;
+        nQuietReads = 0;
+        if(blockSize < maxBlockSize)
+            blockSize *= 2;
+    }
+    else if(blockSize > hop && ++nQuietReads >= quietReadsToShrink) {
+        nQuietReads = 0;
+        if(nFill < blockSize/2) // The partial block must stay partial
+            blockSize /= 2;
+    }
+}
+
+
+// The next start will use a larger device buffer
+void
+PullCapture::onStateChanged(QAudio::State state) {
+    Q_UNUSED(state)
+    if(pSource && pSource->error() != QAudio::NoError)
+        deviceBytes = std::min(2*deviceBytes, maxHops*hop);
+}
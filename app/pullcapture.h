@@ -0,0 +1,76 @@
+/*
+MIT License
+
+Copyright (c) 2022 salvato
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#pragma once
+
+#include <QObject>
+#include <QAudio>
+#include <vector>
+
+
+class IOBuffer;
+class QAudioSource;
+class QIODevice;
+
+
+// Pull mode capture: the audio source is read on readyRead() into a
+// preallocated block and a block is forwarded to the IOBuffer (and so
+// to the detector) only when it is full, whatever the chunk size the
+// backend is using. The block starts at the configured hop and grows
+// (up to maxHops hops) when the backend delivers bursts of several
+// blocks, shrinking back when the bursts are over. A block never
+// overwrites the samples the detector reads in place from the ring.
+// The device buffer starts small and is doubled after any capture error.
+class PullCapture : public QObject
+{
+    Q_OBJECT
+public:
+    explicit PullCapture(IOBuffer* pIOBuffer, QObject* parent = nullptr);
+    void setReservedSamples(int nSamples);
+    bool start(QAudioSource* pAudioSource, int hopBytes);
+    void stop();
+    int blockBytes() const;
+    int deviceBufferBytes() const;
+    quint64 bursts() const;
+
+    static const int maxHops = 8;
+
+private slots:
+    void onReadyRead();
+    void onStateChanged(QAudio::State state);
+
+private:
+    IOBuffer* pBuffer;
+    QAudioSource* pSource;
+    QIODevice* pDevice;
+    std::vector<char> block;
+    int nFill;
+    int hop;
+    int blockSize;
+    int maxBlockSize;
+    int nReserved;
+    int deviceBytes;
+    int nQuietReads;
+    quint64 nBursts;
+};
@@ -26,32 +26,21 @@ SOFTWARE.
 
 #include <QPainter>
 #include <QPainterPath>
+#include <QPaintEvent>
+#include <QResizeEvent>
 #include <QMessageBox>
 #include <QDebug>
 
 
-// Per rendere trasparente lo sfondo bianco di una immagine
-// tramite linea di comando:
-// $ convert original.png -transparent white transparent.png
-
 StaffArea::StaffArea(QWidget *parent)
     : QWidget(parent)
     , xBound(10)
     , yTop(20)
-    , lineSpace(20)
+    , lineSpace(defaultLineSpace)
     , noteNum(-1)
     , octaveBase(1)
     , bRevealNote(false)
 {
-    chiave.load(":/ChiaveViolino.png");
-    chiave = chiave.scaled(4*lineSpace, 5*lineSpace);
-
-    semibreve.load(":/Semibreve.png");
-    semibreve = semibreve.scaled(lineSpace, lineSpace);
-
-    diesis.load(":/Diesis.png");
-    diesis = diesis.scaled(lineSpace, lineSpace);
-
     brushStyle = Qt::BrushStyle(Qt::BrushStyle::SolidPattern);
     brush = QBrush(Qt::black, brushStyle);
 
@@ -61,22 +50,23 @@ StaffArea::StaffArea(QWidget *parent)
     penJoin  = Qt::PenJoinStyle(Qt::PenJoinStyle::RoundJoin);
     pen = QPen(Qt::black, penWidth, penStyle, penCap, penJoin);
 
+    // The cached background covers the whole widget
     setBackgroundRole(QPalette::Base);
-    setAutoFillBackground(true);
+    setAttribute(Qt::WA_OpaquePaintEvent);
 }
 
 
 QSize
 StaffArea::minimumSizeHint() const
 {
-    return QSize(10*lineSpace+2*xBound, 12*lineSpace+2*yTop);
+    return QSize(10*defaultLineSpace+2*xBound, 12*defaultLineSpace+2*yTop);
 }
 
 
 QSize
 StaffArea::sizeHint() const
 {
-    return QSize(600, 12*lineSpace+2*yTop);
+    return QSize(600, 12*defaultLineSpace+2*yTop);
 }
 
 
@@ -87,81 +77,187 @@ StaffArea::setOctaveBase(int iOctave) {
 
 
 void
-StaffArea::setNote(Note newNote, int noteIndex) {
-    noteNum = noteIndex;
-    if(noteNum >= 0) {
-        note = newNote;
-        octave = noteIndex/12-octaveBase;
+StaffArea::setNote(const Note& newNote, int noteIndex) {
+    chordNotes.clear();
+    chordNums.clear();
+    if(noteIndex >= 0) {
+        chordNotes.push_back(newNote);
+        chordNums.push_back(noteIndex);
+    }
+    update(noteRegion());
+}
+
+
+// Dyads and triads are drawn as stacked semibreves
+void
+StaffArea::setChord(const std::vector<Note>& notes, const std::vector<int>& noteIndexes) {
+    chordNotes.clear();
+    chordNums.clear();
+    for(int noteIndex : noteIndexes) {
+        chordNotes.push_back(notes[noteIndex]);
+        chordNums.push_back(noteIndex);
+    }
+    update(noteRegion());
+}
+
+
+// Only the note column and the name below it change between notes
+QRegion
+StaffArea::noteRegion() const {
+    int xNote = (width()+xBound)/2;
+    QRegion region(xNote-2*lineSpace-penWidth, 0, 5*lineSpace+2*penWidth, height());
+    region += QRect(0, height()-height()/12, width(), height()/12);
+    return region;
+}
+
+
+// The glyphs and the background are rendered here (and on a change
+// of screen), never in paintEvent()
+void
+StaffArea::resizeEvent(QResizeEvent* event) {
+    layoutStaff();
+    renderBackground();
+    QWidget::resizeEvent(event);
+}
+
+
+// The window moved to a screen with another pixel ratio (or the
+// ratio of its screen changed)
+bool
+StaffArea::event(QEvent* event) {
+    bool bResult = QWidget::event(event);
+    bool bScreenChange = event->type() == QEvent::ScreenChangeInternal;
+#if QT_VERSION >= QT_VERSION_CHECK(6, 6, 0)
+    bScreenChange = bScreenChange || event->type() == QEvent::DevicePixelRatioChange;
+#endif
+    if(bScreenChange &&
+       !background.isNull() &&
+       background.devicePixelRatio() != devicePixelRatioF()) {
+        layoutStaff();
+        renderBackground();
+        update();
+    }
+    return bResult;
+}
+
+
+// The staff (with its ledger lines and the name below) takes 12 line
+// spaces between the margins: the line space follows the height of
+// the widget, as long as the clef and the note still fit in its width
+void
+StaffArea::layoutStaff() {
+    lineSpace = qMax(minLineSpace,
+                     qMin((height()-2*yTop)/12, (width()-2*xBound)/10));
+    prepareGlyphs(devicePixelRatioF());
+}
+
+
+// Only a lookup, unless the size or the screen changed
+void
+StaffArea::prepareGlyphs(qreal dpr) {
+    GlyphCache& glyphs = GlyphCache::shared();
+    chiave    = glyphs.pixmap(GlyphCache::Clef,      QSize(4*lineSpace, 5*lineSpace), dpr);
+    semibreve = glyphs.pixmap(GlyphCache::Semibreve, QSize(lineSpace, lineSpace), dpr);
+    diesis    = glyphs.pixmap(GlyphCache::Sharp,     QSize(lineSpace, lineSpace), dpr);
+}
+
+
+// The clef and the staff lines, rendered once per size at the
+// device pixel ratio of the screen
+void
+StaffArea::renderBackground() {
+    qreal dpr = devicePixelRatioF();
+    background = QPixmap(size()*dpr);
+    background.setDevicePixelRatio(dpr);
+    background.fill(palette().color(QPalette::Base));
+
+    QPainter painter(&background);
+    painter.setPen(pen);
+    painter.setRenderHint(QPainter::Antialiasing, true);
+    painter.drawPixmap(xBound, 2*lineSpace+yTop, chiave);
+    for(int i=2; i<7; i++) {
+        int yLine = i*lineSpace+yTop;
+        painter.drawLine(QPoint(xBound, yLine), QPoint(width()-xBound, yLine));
     }
-    update();
+    labelFont = font();
+    labelFont.setPixelSize(qMax(1, height()/12));
 }
 
 
 void
-StaffArea::paintEvent(QPaintEvent* /* event */) {
+StaffArea::paintEvent(QPaintEvent* event) {
     QPainter painter(this);
+    const QRect dirty = event->rect();
+    const qreal dpr = background.devicePixelRatio();
+    painter.drawPixmap(QRectF(dirty), background,
+                       QRectF(dirty.x()*dpr, dirty.y()*dpr,
+                              dirty.width()*dpr, dirty.height()*dpr));
+
+    if(chordNums.empty()) return; // No Note To Display...
+
     painter.setPen(pen);
     painter.setBrush(brush);
     painter.setRenderHint(QPainter::Antialiasing, true);
-    QFont font = painter.font();
-    font.setPixelSize(height()/12);
-    painter.setFont(font);
+    painter.setFont(labelFont);
 
-    // Draw the staff
-    painter.drawImage(xBound, 3*lineSpace, chiave);
-    for(int i=2; i<7; i++) {
-        y = i*lineSpace+yTop;
-        painter.drawLine(QPoint(xBound, y), QPoint(width()-xBound, y));
+    QString sNames;
+    for(size_t i=0; i<chordNums.size(); i++) {
+        noteNum = chordNums[i];
+        octave  = noteNum/12-octaveBase;
+        drawNote(&painter);
+        sNames += (i > 0 ? "  " : "")+chordNotes[i].name();
+    }
+    if(bRevealNote) {
+        painter.drawText(QRect(4*lineSpace, height()-(height()/12), width(), 3*lineSpace),
+                         Qt::AlignLeft,
+                         sNames);
     }
+}
 
-    if(noteNum < 0) return; // noteNum < 0 means No Note To Display...
 
+void
+StaffArea::drawNote(QPainter* painter) {
     switch(noteNum % 12) { // The Big Switch to Handle the Musical Notes
         case 0: // C
-            handleC(&painter);
+            handleC(painter);
             break;
         case 1: // C#
-            handleCsharp(&painter);
+            handleCsharp(painter);
             break;
         case 2: // D
-            handleD(&painter);
+            handleD(painter);
             break;
         case 3: // D#
-            handleDsharp(&painter);
+            handleDsharp(painter);
             break;
         case 4: // E
-            handleE(&painter);
+            handleE(painter);
             break;
         case 5: // F
-            handleF(&painter);
+            handleF(painter);
             break;
         case 6: // F#
-            handleFsharp(&painter);
+            handleFsharp(painter);
             break;
         case 7: // G
-            handleG(&painter);
+            handleG(painter);
             break;
         case 8: // G#
-            handleGsharp(&painter);
+            handleGsharp(painter);
             break;
         case 9: // A
-            handleA(&painter);
+            handleA(painter);
             break;
         case 10: // A#
-            handleAsharp(&painter);
+            handleAsharp(painter);
             break;
         case 11: // B
-            handleB(&painter);
+            handleB(painter);
             break;
         default:
             errorMessage(QString("%1 Line %2").arg(__FUNCTION__).arg(__LINE__));
             return;
     }
-    if(bRevealNote) {
-        painter.drawText(QRect(4*lineSpace, height()-(height()/12), width(), 3*lineSpace),
-                         Qt::AlignLeft,
-                         note.sname);
-    }
 }
 
 
@@ -191,7 +287,7 @@ StaffArea::handleC(QPainter* painter){
         errorMessage(QString("%1 Line %2").arg(__FUNCTION__).arg(__LINE__));
         return;
     }
-    painter->drawImage(x, y-lineSpace/2, semibreve);
+    painter->drawPixmap(x, y-lineSpace/2, semibreve);
 }
 
 // Sbaglia a disegnare C#3 con corda E
@@ -220,9 +316,9 @@ StaffArea::handleCsharp(QPainter* painter) {
         errorMessage(QString("%1 Line %2").arg(__FUNCTION__).arg(__LINE__));
         return;
     }
-    painter->drawImage(x, y-lineSpace/2, diesis);
+    painter->drawPixmap(x, y-lineSpace/2, diesis);
     x = (width()+xBound)/2;
-    painter->drawImage(x, y-lineSpace/2, semibreve);
+    painter->drawPixmap(x, y-lineSpace/2, semibreve);
 }
 
 
@@ -242,7 +338,7 @@ StaffArea::handleD(QPainter* painter) {
         errorMessage(QString("%1 Line %2").arg(__FUNCTION__).arg(__LINE__));
         return;
     }
-    painter->drawImage(x, y-lineSpace/2, semibreve);
+    painter->drawPixmap(x, y-lineSpace/2, semibreve);
 }
 
 
@@ -262,9 +358,9 @@ StaffArea::handleDsharp(QPainter* painter) {
         errorMessage(QString("%1 Line %2").arg(__FUNCTION__).arg(__LINE__));
         return;
     }
-    painter->drawImage(x, y-lineSpace/2, diesis);
+    painter->drawPixmap(x, y-lineSpace/2, diesis);
     x = (width()+xBound)/2;
-    painter->drawImage(x, y-lineSpace/2, semibreve);
+    painter->drawPixmap(x, y-lineSpace/2, semibreve);
 }
 
 
@@ -284,7 +380,7 @@ StaffArea::handleE(QPainter* painter) {
         errorMessage(QString("%1 Line %2").arg(__FUNCTION__).arg(__LINE__));
         return;
     }
-    painter->drawImage(x, y-lineSpace/2, semibreve);
+    painter->drawPixmap(x, y-lineSpace/2, semibreve);
 }
 
 
@@ -304,7 +400,7 @@ StaffArea::handleF(QPainter* painter) {
         errorMessage(QString("%1 Line %2").arg(__FUNCTION__).arg(__LINE__));
         return;
     }
-    painter->drawImage(x, y-lineSpace/2, semibreve);
+    painter->drawPixmap(x, y-lineSpace/2, semibreve);
 }
 
 
@@ -324,9 +420,9 @@ StaffArea::handleFsharp(QPainter* painter) {
         errorMessage(QString("%1 Line %2").arg(__FUNCTION__).arg(__LINE__));
         return;
     }
-    painter->drawImage(x, y-lineSpace/2, diesis);
+    painter->drawPixmap(x, y-lineSpace/2, diesis);
     x = (width()+xBound)/2;
-    painter->drawImage(x, y-lineSpace/2, semibreve);
+    painter->drawPixmap(x, y-lineSpace/2, semibreve);
 }
 
 
@@ -346,7 +442,7 @@ StaffArea::handleG(QPainter* painter) {
         errorMessage(QString("%1 Line %2").arg(__FUNCTION__).arg(__LINE__));
         return;
     }
-    painter->drawImage(x, y-lineSpace/2, semibreve);
+    painter->drawPixmap(x, y-lineSpace/2, semibreve);
 }
 
 
@@ -366,9 +462,9 @@ StaffArea::handleGsharp(QPainter* painter) {
         errorMessage(QString("%1 Line %2").arg(__FUNCTION__).arg(__LINE__));
         return;
     }
-    painter->drawImage(x, y-lineSpace/2, diesis);
+    painter->drawPixmap(x, y-lineSpace/2, diesis);
     x = (width()+xBound)/2;
-    painter->drawImage(x, y-lineSpace/2, semibreve);
+    painter->drawPixmap(x, y-lineSpace/2, semibreve);
 }
 
 
@@ -397,7 +493,7 @@ StaffArea::handleA(QPainter* painter) {
         errorMessage(QString("%1 Line %2").arg(__FUNCTION__).arg(__LINE__));
         return;
     }
-    painter->drawImage(x, y-lineSpace/2, semibreve);
+    painter->drawPixmap(x, y-lineSpace/2, semibreve);
 }
 
 
@@ -426,9 +522,9 @@ StaffArea::handleAsharp(QPainter* painter) {
         errorMessage(QString("%1 Line %2").arg(__FUNCTION__).arg(__LINE__));
         return;
     }
-    painter->drawImage(x, y-lineSpace/2, diesis);
+    painter->drawPixmap(x, y-lineSpace/2, diesis);
     x = (width()+xBound)/2;
-    painter->drawImage(x, y-lineSpace/2, semibreve);
+    painter->drawPixmap(x, y-lineSpace/2, semibreve);
 }
 
 
@@ -455,7 +551,7 @@ StaffArea::handleB(QPainter* painter) {
         errorMessage(QString("%1 Line %2").arg(__FUNCTION__).arg(__LINE__));
         return;
     }
-    painter->drawImage(x, y-lineSpace/2, semibreve);
+    painter->drawPixmap(x, y-lineSpace/2, semibreve);
 }
 
 
@@ -25,12 +25,16 @@ SOFTWARE.
 #pragma once
 
 #include "note.h"
+#include "glyphcache.h"
 
 #include <QWidget>
 #include <QBrush>
 #include <QPen>
 #include <QPixmap>
 #include <QImage>
+#include <QFont>
+#include <QRegion>
+#include <vector>
 
 
 class StaffArea : public QWidget
@@ -40,7 +44,8 @@ public:
     explicit StaffArea(QWidget *parent = nullptr);
     QSize minimumSizeHint() const override;
     QSize sizeHint() const override;
-    void setNote(Note note, int noteIndex);
+    void setNote(const Note& note, int noteIndex);
+    void setChord(const std::vector<Note>& notes, const std::vector<int>& noteIndexes);
     void setSensitivity(double sensitivity);
     void setOctaveBase(int iOctave);
     void setRevealNote(bool bReveal);
@@ -48,8 +53,15 @@ public:
 signals:
 
 protected:
+    bool event(QEvent *event) override;
     void paintEvent(QPaintEvent *event) override;
+    void resizeEvent(QResizeEvent *event) override;
+    void renderBackground();
+    QRegion noteRegion() const;
+    void layoutStaff();
+    void prepareGlyphs(qreal dpr);
     void errorMessage(QString sError);
+    void drawNote(QPainter* painter);
     void handleC(QPainter* painter);
     void handleCsharp(QPainter* painter);
     void handleD(QPainter* painter);
@@ -64,12 +76,16 @@ protected:
     void handleB(QPainter* painter);
 
 private:
-    QImage chiave;
-    QImage semibreve;
-    QImage diesis;
+    static constexpr int defaultLineSpace = 20;
+    static constexpr int minLineSpace = 8;
+    QPixmap chiave;
+    QPixmap semibreve;
+    QPixmap diesis;
     QPen pen;
     QBrush brush;
     QImage pixmap;
+    QPixmap background;
+    QFont labelFont;
     int penWidth;
     Qt::PenStyle penStyle;
     Qt::PenCapStyle penCap;
@@ -78,7 +94,8 @@ private:
     int xBound;
     int yTop;
     int lineSpace;
-    Note note;
+    std::vector<Note> chordNotes;
+    std::vector<int> chordNums;
     int noteNum;
     int octave;
     int octaveBase;
@@ -0,0 +1,56 @@
+#MIT License
+
+#Copyright (c) 2022 salvato
+
+#Permission is hereby granted, free of charge, to any person obtaining a copy
+#of this software and associated documentation files (the "Software"), to deal
+#in the Software without restriction, including without limitation the rights
+#to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+#copies of the Software, and to permit persons to whom the Software is
+#furnished to do so, subject to the following conditions:
+
+#The above copyright notice and this permission notice shall be included in all
+#copies or substantial portions of the Software.
+
+#THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+#IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+#FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+#AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+#LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+#OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+#SOFTWARE.
+
+# Microbenchmarks of the NoteLearn hot paths (Google Benchmark).
+# The library is found through pkg-config (package "benchmark").
+
+QT += core
+QT += gui
+QT += widgets
+
+CONFIG += c++17 console link_pkgconfig
+CONFIG -= app_bundle
+PKGCONFIG += benchmark
+
+TARGET = NoteBench
+
+DEFINES += QT_DISABLE_DEPRECATED_BEFORE=0x060000    # disables all the APIs deprecated before Qt 6.0.0
+
+# The detectors, the note tables and the capture buffer
+include(../core/core.pri)
+INCLUDEPATH += ../app
+
+SOURCES += \
+    dspbench.cpp \
+    main.cpp \
+    uibench.cpp \
+    ../app/glyphcache.cpp \
+    ../app/staffarea.cpp
+
+HEADERS += \
+    benchutil.h \
+    ../app/glyphcache.h \
+    ../app/staffarea.h
+
+# The images of the staff
+RESOURCES += \
+    ../NoteLearn.qrc
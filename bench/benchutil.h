@@ -0,0 +1,56 @@
+/*
+MIT License
+
+Copyright (c) 2022 salvato
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#pragma once
+
+#include "note.h"
+#include <cmath>
+#include <vector>
+
+
+// The notes table of the App
+inline const std::vector<Note>&
+noteTable() {
+    static const std::vector<Note> notes = equalTemperament();
+    return notes;
+}
+
+
+// A plucked A3 (220 Hz) with a few decaying harmonics
+inline std::vector<float>
+testSignal(int sampleRate, int nSamples) {
+    const double pi = 3.14159265358979323846;
+    std::vector<float> x(nSamples);
+    for(int t=0; t<nSamples; t++) {
+        double value = 0.0;
+        for(int h=1; h<=6; h++)
+            value += 0.3/h*std::sin(2.0*pi*220.0*h*t/sampleRate)*std::exp(-double(t)*h/sampleRate);
+        x[t] = float(value);
+    }
+    return x;
+}
+
+
+// Sample rates and block durations (ms) of every benchmark
+#define RATE_AND_BLOCK_ARGS ArgsProduct({{12000, 24000, 48000}, {50, 150}})
@@ -0,0 +1,280 @@
+/*
+MIT License
+
+Copyright (c) 2022 salvato
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+// Benchmarks of the detection hot paths (no Qt event loop is needed).
+// Every one is parametrized by the sample rate and the block duration:
+// state.range(0) is the rate (Hz) and state.range(1) the block (ms).
+
+#include "benchutil.h"
+#include "acfkernel.h"
+#include "acfdetector.h"
+#include "yindetector.h"
+#include "mpmdetector.h"
+#include "goertzeldetector.h"
+#include "polyphonicdetector.h"
+#include "decimator.h"
+#include "signalgate.h"
+#include "fft.h"
+#include "dspworker.h"
+
+#include <benchmark/benchmark.h>
+#include <algorithm>
+#include <memory>
+
+
+static int
+blockSamples(const benchmark::State& state) {
+    return int(state.range(0)*state.range(1)/1000);
+}
+
+
+// The detectors analyse a 0.3 s window (longer than the period of
+// every note) and the block is the part of it that is new
+static int
+detectorWindow(const benchmark::State& state) {
+    return int(state.range(0)*0.3);
+}
+
+
+// The lags of the notes of the guitar (E2 and up) at the given rate
+static std::vector<int>
+noteLags(int sampleRate) {
+    std::vector<int> lags;
+    const std::vector<Note>& notes = noteTable();
+    for(size_t i=NoteTable::firstGuitarNote; i<notes.size(); i++)
+        lags.push_back(int(double(sampleRate)/notes[i].frequency+0.5));
+    return lags;
+}
+
+
+// The correlation loop of the original OnBufferFull(): selected kernel...
+static void
+BM_AcfAccumulate(benchmark::State& state) {
+    std::vector<int> lags = noteLags(int(state.range(0)));
+    int nProducts = blockSamples(state);
+    std::vector<float> x = testSignal(int(state.range(0)), nProducts+lags.front());
+    std::vector<double> R(lags.size());
+    for(auto _ : state) {
+        acfAccumulate(x.data(), nProducts, lags.data(), int(lags.size()), R.data());
+        benchmark::DoNotOptimize(R.data());
+    }
+    state.SetItemsProcessed(state.iterations()*nProducts*int64_t(lags.size()));
+    state.SetLabel(acfKernelName());
+}
+BENCHMARK(BM_AcfAccumulate)->RATE_AND_BLOCK_ARGS;
+
+
+// ...and the plain C++ reference
+static void
+BM_AcfAccumulateScalar(benchmark::State& state) {
+    std::vector<int> lags = noteLags(int(state.range(0)));
+    int nProducts = blockSamples(state);
+    std::vector<float> x = testSignal(int(state.range(0)), nProducts+lags.front());
+    std::vector<double> R(lags.size());
+    for(auto _ : state) {
+        acfAccumulateScalar(x.data(), nProducts, lags.data(), int(lags.size()), R.data());
+        benchmark::DoNotOptimize(R.data());
+    }
+    state.SetItemsProcessed(state.iterations()*nProducts*int64_t(lags.size()));
+}
+BENCHMARK(BM_AcfAccumulateScalar)->RATE_AND_BLOCK_ARGS;
+
+
+// The fixed point kernel, on the int16 samples...
+static void
+BM_AcfAccumulateInt16(benchmark::State& state) {
+    std::vector<int> lags = noteLags(int(state.range(0)));
+    int nProducts = blockSamples(state);
+    std::vector<float> x = testSignal(int(state.range(0)), nProducts+lags.front());
+    std::vector<int16_t> samples(x.size());
+    for(size_t t=0; t<x.size(); t++)
+        samples[t] = int16_t(x[t]*16384.0f);
+    std::vector<int64_t> R(lags.size());
+    for(auto _ : state) {
+        acfAccumulateInt16(samples.data(), nProducts, lags.data(), int(lags.size()), R.data());
+        benchmark::DoNotOptimize(R.data());
+    }
+    state.SetItemsProcessed(state.iterations()*nProducts*int64_t(lags.size()));
+    state.SetLabel(acfInt16KernelName());
+}
+BENCHMARK(BM_AcfAccumulateInt16)->RATE_AND_BLOCK_ARGS;
+
+
+// ...that does not need this conversion of every block
+static void
+BM_AcfToFloat(benchmark::State& state) {
+    int nSamples = blockSamples(state);
+    std::vector<int16_t> samples(nSamples, 1000);
+    std::vector<float> x(nSamples);
+    for(auto _ : state) {
+        acfToFloat(samples.data(), nSamples, x.data());
+        benchmark::DoNotOptimize(x.data());
+    }
+    state.SetItemsProcessed(state.iterations()*nSamples);
+}
+BENCHMARK(BM_AcfToFloat)->RATE_AND_BLOCK_ARGS;
+
+
+// The full autocorrelation (every lag) through the FFT
+static void
+BM_FftAutocorrelation(benchmark::State& state) {
+    int nSamples = blockSamples(state);
+    std::vector<float> x = testSignal(int(state.range(0)), nSamples);
+    FftAutocorrelation acf;
+    int nProducts = nSamples-noteLags(int(state.range(0))).front();
+    for(auto _ : state)
+        benchmark::DoNotOptimize(acf.compute(x.data(), nSamples, nProducts));
+    state.SetItemsProcessed(state.iterations()*nSamples);
+}
+BENCHMARK(BM_FftAutocorrelation)->RATE_AND_BLOCK_ARGS;
+
+
+// The lag table built once in the MainWindow constructor
+// (now by the detector, for the rate it works at)
+static void
+BM_LagTableSetup(benchmark::State& state) {
+    for(auto _ : state) {
+        AcfDetector detector(noteTable(), int(state.range(0)), detectorWindow(state), AcfDetector::SparseLags);
+        benchmark::DoNotOptimize(&detector);
+    }
+}
+BENCHMARK(BM_LagTableSetup)->RATE_AND_BLOCK_ARGS;
+
+
+enum DetectorKind {
+    AcfSparse,
+    AcfFft,
+    AcfSliding,
+    Yin,
+    Mpm,
+    Goertzel,
+    Polyphonic
+};
+
+
+static PitchDetector*
+newDetector(DetectorKind kind, int sampleRate, int window) {
+    const std::vector<Note>& notes = noteTable();
+    double minFrequency = notes[NoteTable::firstGuitarNote].frequency*0.97;
+    double maxFrequency = notes.back().frequency*1.03;
+    switch(kind) {
+        case AcfSparse:  return new AcfDetector(notes, sampleRate, window, AcfDetector::SparseLags);
+        case AcfFft:     return new AcfDetector(notes, sampleRate, window, AcfDetector::FullFft);
+        case AcfSliding: return new AcfDetector(notes, sampleRate, window, AcfDetector::Sliding);
+        case Yin:        return new YinDetector(notes, sampleRate, minFrequency, maxFrequency);
+        case Mpm:        return new MpmDetector(notes, sampleRate, minFrequency, maxFrequency);
+        case Goertzel:   return new GoertzelDetector(notes, sampleRate, window);
+        default:         return new PolyphonicDetector(notes, sampleRate);
+    }
+}
+
+
+// One block of every detector, as DspWorker::process() runs it.
+// The sparse and the FFT engines of the autocorrelation detector
+// compute the same values: here they can be compared.
+static void
+BM_Detector(benchmark::State& state, DetectorKind kind) {
+    int sampleRate = int(state.range(0));
+    int window = detectorWindow(state);
+    std::unique_ptr<PitchDetector> pDetector(newDetector(kind, sampleRate, window));
+    pDetector->setCandidates(34, 46); // A string
+    pDetector->setThreshold(0.0);
+    int nSamples = pDetector->maxWindowSamples();
+    std::vector<float> x = testSignal(sampleRate, nSamples);
+    int nNew = std::min(nSamples, blockSamples(state));
+    PitchEstimate estimate;
+    for(auto _ : state) {
+        benchmark::DoNotOptimize(pDetector->process(x.data(), nSamples, nNew, &estimate));
+    }
+    state.SetItemsProcessed(state.iterations()*nNew);
+    state.SetLabel(pDetector->name());
+}
+BENCHMARK_CAPTURE(BM_Detector, AcfSparse,  AcfSparse)->RATE_AND_BLOCK_ARGS;
+BENCHMARK_CAPTURE(BM_Detector, AcfFft,     AcfFft)->RATE_AND_BLOCK_ARGS;
+BENCHMARK_CAPTURE(BM_Detector, AcfSliding, AcfSliding)->RATE_AND_BLOCK_ARGS;
+BENCHMARK_CAPTURE(BM_Detector, Yin,        Yin)->RATE_AND_BLOCK_ARGS;
+BENCHMARK_CAPTURE(BM_Detector, Mpm,        Mpm)->RATE_AND_BLOCK_ARGS;
+BENCHMARK_CAPTURE(BM_Detector, Goertzel,   Goertzel)->RATE_AND_BLOCK_ARGS;
+BENCHMARK_CAPTURE(BM_Detector, Polyphonic, Polyphonic)->RATE_AND_BLOCK_ARGS;
+
+
+// The Goertzel bank of the selected string against the sparse lags
+// loop of the original detector, both on one block of the App (the
+// hop is the window of the bank). The second argument is the string.
+static void
+BM_StringBlock(benchmark::State& state, DetectorKind kind) {
+    int sampleRate = int(state.range(0));
+    int hop = DspWorker::defaultWindowSamples(sampleRate);
+    int firstNote = NoteTable::stringStart[state.range(1)];
+    std::unique_ptr<PitchDetector> pDetector(newDetector(kind, sampleRate, hop));
+    pDetector->setCandidates(firstNote, firstNote+NoteTable::nFrets);
+    pDetector->setThreshold(0.0);
+    int nSamples = pDetector->maxWindowSamples();
+    std::vector<float> x = testSignal(sampleRate, nSamples);
+    PitchEstimate estimate;
+    for(auto _ : state) {
+        benchmark::DoNotOptimize(pDetector->process(x.data(), nSamples, hop, &estimate));
+    }
+    state.SetItemsProcessed(state.iterations()*hop);
+    state.SetLabel(pDetector->name());
+}
+BENCHMARK_CAPTURE(BM_StringBlock, AcfSparse, AcfSparse)->ArgsProduct({{12000, 24000, 48000}, {0, 5}});
+BENCHMARK_CAPTURE(BM_StringBlock, Goertzel,  Goertzel)->ArgsProduct({{12000, 24000, 48000}, {0, 5}});
+
+
+static std::vector<int16_t>
+testSamples(int sampleRate, int nSamples) {
+    std::vector<float> x = testSignal(sampleRate, nSamples);
+    std::vector<int16_t> samples(nSamples);
+    for(int t=0; t<nSamples; t++)
+        samples[t] = int16_t(x[t]*16384.0f);
+    return samples;
+}
+
+
+// Decimation by 4 of one block (the rate is the input rate)
+static void
+BM_Decimator(benchmark::State& state) {
+    int nSamples = blockSamples(state);
+    std::vector<int16_t> samples = testSamples(int(state.range(0)), nSamples);
+    Decimator decimator(4, nSamples/4);
+    for(auto _ : state)
+        benchmark::DoNotOptimize(decimator.push(samples.data(), nSamples));
+    state.SetItemsProcessed(state.iterations()*nSamples);
+}
+BENCHMARK(BM_Decimator)->RATE_AND_BLOCK_ARGS;
+
+
+// The energy/onset gate that runs on every block
+static void
+BM_SignalGate(benchmark::State& state) {
+    int nSamples = blockSamples(state);
+    std::vector<int16_t> samples = testSamples(int(state.range(0)), nSamples);
+    SignalGate gate(int(state.range(0)));
+    gate.setThreshold(1.0e-4);
+    for(auto _ : state)
+        benchmark::DoNotOptimize(gate.push(samples.data(), nSamples));
+    state.SetItemsProcessed(state.iterations()*nSamples);
+}
+BENCHMARK(BM_SignalGate)->RATE_AND_BLOCK_ARGS;
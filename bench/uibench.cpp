@@ -0,0 +1,121 @@
+/*
+MIT License
+
+Copyright (c) 2022 salvato
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+// Benchmarks of the Qt side of the hot paths: the audio writes into
+// IOBuffer, the repaint of the staff (into an offscreen QImage) and
+// the classroom mode workers on their shared thread pool.
+
+#include "benchutil.h"
+#include "iobuffer.h"
+#include "dspworker.h"
+#include "staffarea.h"
+
+#include <benchmark/benchmark.h>
+#include <QImage>
+#include <QThreadPool>
+#include <memory>
+
+
+// One write of the audio backend: state.range(0) is the
+// sample rate (Hz) and state.range(1) the block duration (ms)
+static void
+BM_IOBufferWrite(benchmark::State& state) {
+    int nSamples = int(state.range(0)*state.range(1)/1000);
+    std::vector<int16_t> samples(nSamples, 0);
+    // The ring of MainWindow: the longest window (twice the 0.15s
+    // analysis window) and one write
+    IOBuffer buffer(3*DspWorker::defaultWindowSamples(int(state.range(0))));
+    buffer.open(QIODevice::WriteOnly);
+    const char* pBytes = reinterpret_cast<const char*>(samples.data());
+    qint64 nBytes = qint64(nSamples)*qint64(sizeof(int16_t));
+    for(auto _ : state)
+        benchmark::DoNotOptimize(buffer.write(pBytes, nBytes));
+    state.SetBytesProcessed(state.iterations()*nBytes);
+}
+BENCHMARK(BM_IOBufferWrite)->RATE_AND_BLOCK_ARGS;
+
+
+// StaffArea::paintEvent() with a sharp note (the most drawing):
+// state.range(0) x state.range(1) are the widget size
+static void
+BM_StaffAreaPaint(benchmark::State& state) {
+    const std::vector<Note>& notes = noteTable();
+    StaffArea staff;
+    staff.resize(int(state.range(0)), int(state.range(1)));
+    staff.setRevealNote(true);
+    staff.setOctaveBase(0);
+    staff.setNote(notes[30], 30); // F#2 on the E string
+    QImage image(staff.size(), QImage::Format_ARGB32_Premultiplied);
+    for(auto _ : state) {
+        staff.render(&image);
+        benchmark::DoNotOptimize(image.constBits());
+    }
+}
+// The phone and the tablet the App has been tested on
+BENCHMARK(BM_StaffAreaPaint)->Args({360, 717})->Args({1280, 752});
+
+
+// Classroom mode: state.range(0) students at 48 kHz, each writing a
+// 150ms block of a plucked note. The audio_s counter is the seconds of
+// audio analysed per second: it must stay above the number of students.
+static void
+BM_ClassroomPool(benchmark::State& state) {
+    const std::vector<Note>& notes = noteTable();
+    const int sampleRate = 48000;
+    const int nData = DspWorker::defaultWindowSamples(sampleRate);
+    int nStudents = int(state.range(0));
+    std::vector<float> signal = testSignal(sampleRate, nData);
+    std::vector<int16_t> block(nData);
+    for(int i=0; i<nData; i++)
+        block[i] = int16_t(signal[i]*16384.0f);
+    QThreadPool pool;
+    std::vector<std::unique_ptr<IOBuffer>> buffers;
+    std::vector<std::unique_ptr<DspWorker>> workers;
+    for(int i=0; i<nStudents; i++) {
+        buffers.emplace_back(new IOBuffer(2*nData));
+        workers.emplace_back(new DspWorker(buffers.back().get(), notes, sampleRate, nData));
+        buffers.back()->reserve(workers.back()->maxWindowSamples()+nData);
+        IOBuffer* pBuffer = buffers.back().get();
+        DspWorker* pWorker = workers.back().get();
+        pWorker->setThreadPool(&pool);
+        pWorker->setThreshold(DspWorker::defaultThreshold);
+        pWorker->setCandidates(NoteTable::stringStart[0], NoteTable::stringStart[0]+NoteTable::nFrets);
+        pWorker->setActive(true);
+        QObject::connect(pBuffer, &IOBuffer::bufferFull,
+                         pWorker, &DspWorker::onBufferFull,
+                         Qt::DirectConnection);
+        pBuffer->open(QIODevice::WriteOnly);
+    }
+    const char* pBytes = reinterpret_cast<const char*>(block.data());
+    qint64 nBytes = qint64(nData)*qint64(sizeof(int16_t));
+    for(auto _ : state) {
+        for(std::unique_ptr<IOBuffer>& pBuffer : buffers)
+            pBuffer->write(pBytes, nBytes);
+        pool.waitForDone();
+    }
+    state.counters["audio_s"] = benchmark::Counter(0.15*nStudents, benchmark::Counter::kIsIterationInvariantRate);
+    for(std::unique_ptr<DspWorker>& pWorker : workers)
+        pWorker->setActive(false);
+}
+BENCHMARK(BM_ClassroomPool)->Arg(1)->Arg(4)->Arg(16)->Arg(32)->UseRealTime();
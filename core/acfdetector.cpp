@@ -0,0 +1,232 @@
+/*
+MIT License
+
+Copyright (c) 2022 salvato
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include "acfdetector.h"
+#include "acfkernel.h"
+
+#include <algorithm>
+#include <climits>
+
+
+AcfDetector::AcfDetector(const std::vector<Note>& notes, int sampleRate,
+                         int windowSamples, Engine acfEngine)
+    : PitchDetector(notes, sampleRate)
+    , engine(acfEngine)
+    , nData(windowSamples)
+    , nDetections(0)
+    , nAccumulated(0)
+    , bPrimed(false)
+    , nSinceRefresh(0)
+{
+    // Computing the delays where calculate the autocorrelation function
+    // and zeroing the autocorrelation function
+    Lags = int(notes.size()) + 1;
+    acorLags.assign(Lags, 0);
+    R.assign(Lags, 0.0); // R[0]= Energia del Segnale
+    Rint.assign(Lags, 0);
+    // With the default tuning the lags of the common rates are built by the compiler
+    const int* pLags = Lags-1 == NoteTable::nNotes ? NoteTable::precomputedLags(sampleRate) : nullptr;
+    for(int i=0; pLags && i<Lags-1; i++) {
+        if(notes[i].id != i || notes[i].frequency != NoteTable::frequency(i))
+            pLags = nullptr;
+    }
+    for(int i=1; i<Lags; i++) {
+        // Autororrelation Indexes corresponding to Note Periods
+        acorLags[i] = pLags ? pLags[i-1] : int((double)sampleRate/notes[i-1].frequency+0.5);
+    }
+    // The window must hold at least one period of the lowest note
+    // beyond its lag: shorter windows would have no products to sum
+    nData = std::max(nData, 2*acorLags[1]);
+    // With the full autocorrelation every note gets the peak
+    // of the lags halfway to its neighbour notes
+    bandLow.assign(Lags, 0);
+    bandHigh.assign(Lags, 0);
+    bandHigh[1] = acorLags[1];
+    for(int i=1; i<Lags-1; i++) {
+        int middle    = (acorLags[i]+acorLags[i+1])/2;
+        bandLow[i]    = std::min(middle+1, acorLags[i]);
+        bandHigh[i+1] = std::max(middle, acorLags[i+1]);
+    }
+    bandLow[Lags-1] = std::max(1, acorLags[Lags-1]-(bandHigh[Lags-1]-acorLags[Lags-1]));
+    running.assign(Lags, 0.0);
+    added.assign(Lags, 0.0);
+    removed.assign(Lags, 0.0);
+    if(engine == FullFft)
+        fftAcf.prepare(nData);
+}
+
+
+const char*
+AcfDetector::name() const {
+    if(engine == FullFft) return "Autocorrelation (FFT)";
+    if(engine == Sliding) return "Autocorrelation (Sliding)";
+    if(engine == SparseLagsInt16) return "Autocorrelation (Lags, int16)";
+    return "Autocorrelation (Lags)";
+}
+
+
+// The sliding engine also needs the samples leaving the window
+// (up to one whole window of them)
+int
+AcfDetector::windowSamples() const {
+    return engine == Sliding ? 2*nData : nData;
+}
+
+
+// Number of products summed for every lag in a block
+int
+AcfDetector::productsPerBlock() const {
+    return nData-acorLags[1];
+}
+
+
+void
+AcfDetector::reset() {
+    PitchDetector::reset();
+    std::fill(R.begin(), R.end(), 0.0);
+    nDetections  = 0;
+    nAccumulated = 0;
+    bPrimed      = false;
+}
+
+
+// The window is made of the last nData samples of the block: the products
+// x[t]*x[t+lag] with t in [start, start+nProducts) are summed for every lag.
+// When the window moves by n samples the products of the n new values of t
+// are added and those of the n values of t leaving the window are removed:
+// the cost is O(nNewSamples x Lags) instead of O(nData x Lags).
+void
+AcfDetector::slide(const float* x, int nSamples, int nNewSamples) {
+    const int nProducts = productsPerBlock();
+    const int start = nSamples-nData;
+    // Start over after a gap, and from time to time
+    // to get rid of the accumulated rounding errors
+    if(!bPrimed || nNewSamples > start || nSinceRefresh > 100*nData) {
+        std::fill(running.begin(), running.end(), 0.0);
+        acfAccumulate(x+start, nProducts, acorLags.data(), Lags, running.data());
+        bPrimed = true;
+        nSinceRefresh = 0;
+        return;
+    }
+    if(nNewSamples <= 0)
+        return;
+    const int oldStart = start-nNewSamples;
+    std::fill(added.begin(),   added.end(),   0.0);
+    std::fill(removed.begin(), removed.end(), 0.0);
+    acfAccumulate(x+oldStart+nProducts, nNewSamples, acorLags.data(), Lags, added.data());
+    acfAccumulate(x+oldStart,           nNewSamples, acorLags.data(), Lags, removed.data());
+    for(int i=0; i<Lags; i++)
+        running[i] += added[i]-removed[i];
+    nSinceRefresh += nNewSamples;
+}
+
+
+bool
+AcfDetector::process(const float* x, int nSamples, int nNewSamples, PitchEstimate* pEstimate) {
+    if(nSamples < windowSamples())
+        return false;
+    const int nProducts = productsPerBlock();
+    //////////////////////////////////////////////////////////////
+    /// Calcoliamo la funzione di autocorrelazione del segnale ///
+    /// solo nei punti corrispondenti ai periodi delle note.   ///
+    //////////////////////////////////////////////////////////////
+    if(engine == FullFft) {
+        const float* r = fftAcf.compute(x, nData, nProducts);
+        if(!r)
+            return false;
+        R[0] += r[0];
+        for(int i=1; i<Lags; i++) {
+            float peak = r[bandLow[i]];
+            for(int lag=bandLow[i]+1; lag<=bandHigh[i]; lag++)
+                peak = std::max(peak, r[lag]);
+            R[i] += peak;
+        }
+    }
+    else if(engine == Sliding) {
+        slide(x, nSamples, nNewSamples);
+        for(int i=0; i<Lags; i++)
+            R[i] += running[i];
+    }
+    else { // The float version of the fixed point engine too (decimated signals)
+        acfAccumulate(x, nProducts, acorLags.data(), Lags, R.data());
+    }
+    return decide(nProducts, pEstimate);
+}
+
+
+bool
+AcfDetector::acceptsInt16() const {
+    return engine == SparseLagsInt16;
+}
+
+
+// The exact integer sums, scaled as the float samples (divided by SHRT_MAX)
+bool
+AcfDetector::processInt16(const int16_t* x, int nSamples, int nNewSamples, PitchEstimate* pEstimate) {
+    (void)nNewSamples;
+    if(engine != SparseLagsInt16 || nSamples < windowSamples())
+        return false;
+    const int nProducts = productsPerBlock();
+    std::fill(Rint.begin(), Rint.end(), 0);
+    acfAccumulateInt16(x, nProducts, acorLags.data(), Lags, Rint.data());
+    const double scale = 1.0/(double(SHRT_MAX)*double(SHRT_MAX));
+    for(int i=0; i<Lags; i++)
+        R[i] += double(Rint[i])*scale;
+    return decide(nProducts, pEstimate);
+}
+
+
+// The decision of the original detector, on the sums of the last blocks
+bool
+AcfDetector::decide(int nProducts, PitchEstimate* pEstimate) {
+    nAccumulated += nProducts;
+    // If the Signal energy is not enough...
+    if(R[0] < threshold*nProducts) {
+        nDetections = 0;
+        return false;
+    }
+    // The Signal Energy is greater than the treshold
+    nDetections++;
+    if(nDetections < 2) // To avoid nDetections false detections
+        return false;
+    nDetections = 0;
+    // Find the Autocorrelation Max and prepare for the next Audio Buffer
+    double energy = R[0];
+    R[0] = 0.0;
+    double rMax = R[1];
+    int iMax = 1;
+    for(int i=1; i<Lags; i++) {
+        if(R[i] > rMax) {
+            rMax = R[i];
+            iMax = i-1;
+        }
+        R[i] = 0.0;
+    }
+    pEstimate->note       = iMax;
+    pEstimate->frequency  = frequencies[iMax];
+    pEstimate->confidence = std::max(0.0, std::min(1.0, rMax/energy));
+    pEstimate->energy     = energy/double(nAccumulated);
+    nAccumulated = 0;
+    return true;
+}
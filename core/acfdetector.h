@@ -0,0 +1,75 @@
+/*
+MIT License
+
+Copyright (c) 2022 salvato
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#pragma once
+
+#include "pitchdetector.h"
+#include "fft.h"
+
+
+// The original detector: the autocorrelation of the block is evaluated
+// at the period of every note and the note with the largest value wins.
+class AcfDetector : public PitchDetector
+{
+public:
+    enum Engine { // How the autocorrelation is computed
+        SparseLags = 0, // Only at the note periods: O(nData x Lags)
+        FullFft    = 1, // At every lag (Wiener-Khinchin): O(N log N)
+        Sliding    = 2, // Running sums updated with the new samples only
+        SparseLagsInt16 = 3 // As SparseLags, in fixed point on the int16 samples
+    };
+
+public:
+    AcfDetector(const std::vector<Note>& notes, int sampleRate,
+                int windowSamples, Engine acfEngine);
+    const char* name() const override;
+    int windowSamples() const override;
+    bool process(const float* x, int nSamples, int nNewSamples, PitchEstimate* pEstimate) override;
+    bool acceptsInt16() const override;
+    bool processInt16(const int16_t* x, int nSamples, int nNewSamples, PitchEstimate* pEstimate) override;
+    void reset() override;
+    int productsPerBlock() const;
+
+protected:
+    void slide(const float* x, int nSamples, int nNewSamples);
+    bool decide(int nProducts, PitchEstimate* pEstimate);
+
+private:
+    Engine engine;
+    int nData;
+    int Lags;
+    std::vector<int> acorLags;
+    std::vector<double> R;
+    std::vector<int64_t> Rint; // Fixed point sums of one block
+    std::vector<int> bandLow;  // Lags closer to note i than
+    std::vector<int> bandHigh; // to its neighbours (FFT engine)
+    FftAutocorrelation fftAcf;
+    int nDetections;
+    int nAccumulated;
+    std::vector<double> running;  // Sliding engine: sums over the latest window
+    std::vector<double> added;
+    std::vector<double> removed;
+    bool bPrimed;
+    int nSinceRefresh;
+};
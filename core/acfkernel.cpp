@@ -0,0 +1,440 @@
+/*
+MIT License
+
+Copyright (c) 2022 salvato
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include "acfkernel.h"
+
+#include <algorithm>
+#include <climits>
+#include <cmath>
+#include <vector>
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+    #define ACF_X86
+    #include <immintrin.h>
+#elif defined(__ARM_NEON) || defined(__aarch64__)
+    #define ACF_NEON
+    #include <arm_neon.h>
+#endif
+
+#if defined(ACF_X86) && (defined(__GNUC__) || defined(__clang__))
+    #define ACF_AVX2 // GCC and Clang can build the AVX2 kernel as a separate target
+#endif
+
+
+typedef void (*AcfKernel)(const float*, int, const int*, int, double*);
+typedef void (*AcfInt16Kernel)(const int16_t*, int, const int*, int, int64_t*);
+
+
+void
+acfToFloat(const int16_t* pIn, int nSamples, float* pOut) {
+    const float scale = 1.0f/float(SHRT_MAX);
+    for(int i=0; i<nSamples; i++)
+        pOut[i] = float(pIn[i])*scale;
+}
+
+
+void
+acfAccumulateScalar(const float* x, int nProducts,
+                    const int* lags, int nLags, double* R) {
+    for(int k=0; k<nLags; k++) {
+        const float* y = x+lags[k];
+        float s0 = 0.0f, s1 = 0.0f, s2 = 0.0f, s3 = 0.0f;
+        int t = 0;
+        for(; t+4<=nProducts; t+=4) {
+            s0 += x[t  ]*y[t  ];
+            s1 += x[t+1]*y[t+1];
+            s2 += x[t+2]*y[t+2];
+            s3 += x[t+3]*y[t+3];
+        }
+        for(; t<nProducts; t++)
+            s0 += x[t]*y[t];
+        R[k] += double(s0)+double(s1)+double(s2)+double(s3);
+    }
+}
+
+
+void
+acfCopyInt16(const int16_t* pIn, int nSamples, int16_t* pOut) {
+    for(int i=0; i<nSamples; i++)
+        pOut[i] = pIn[i] < -SHRT_MAX ? int16_t(-SHRT_MAX) : pIn[i];
+}
+
+
+void
+acfAccumulateInt16Scalar(const int16_t* x, int nProducts,
+                         const int* lags, int nLags, int64_t* R) {
+    for(int k=0; k<nLags; k++) {
+        const int16_t* y = x+lags[k];
+        int64_t sum = 0;
+        for(int t=0; t<nProducts; t++)
+            sum += int32_t(x[t])*int32_t(y[t]);
+        R[k] += sum;
+    }
+}
+
+
+#if defined(ACF_X86)
+static void
+acfAccumulateSse2(const float* x, int nProducts,
+                  const int* lags, int nLags, double* R) {
+    for(int k=0; k<nLags; k++) {
+        const float* y = x+lags[k];
+        __m128 s0 = _mm_setzero_ps();
+        __m128 s1 = _mm_setzero_ps();
+        int t = 0;
+        for(; t+8<=nProducts; t+=8) {
+            s0 = _mm_add_ps(s0, _mm_mul_ps(_mm_loadu_ps(x+t),   _mm_loadu_ps(y+t)));
+            s1 = _mm_add_ps(s1, _mm_mul_ps(_mm_loadu_ps(x+t+4), _mm_loadu_ps(y+t+4)));
+        }
+        float lanes[4];
+        _mm_storeu_ps(lanes, _mm_add_ps(s0, s1));
+        double sum = double(lanes[0])+double(lanes[1])+double(lanes[2])+double(lanes[3]);
+        for(; t<nProducts; t++)
+            sum += double(x[t]*y[t]);
+        R[k] += sum;
+    }
+}
+#endif
+
+
+#if defined(ACF_X86)
+// Every madd lane (the sum of two products) fits an int32 only
+// because -32768 is excluded: the lanes are widened before summing
+static void
+acfAccumulateInt16Sse2(const int16_t* x, int nProducts,
+                       const int* lags, int nLags, int64_t* R) {
+    for(int k=0; k<nLags; k++) {
+        const int16_t* y = x+lags[k];
+        __m128i s = _mm_setzero_si128();
+        int t = 0;
+        for(; t+8<=nProducts; t+=8) {
+            __m128i p = _mm_madd_epi16(_mm_loadu_si128(reinterpret_cast<const __m128i*>(x+t)),
+                                       _mm_loadu_si128(reinterpret_cast<const __m128i*>(y+t)));
+            __m128i sign = _mm_srai_epi32(p, 31);
+            s = _mm_add_epi64(s, _mm_add_epi64(_mm_unpacklo_epi32(p, sign),
+                                               _mm_unpackhi_epi32(p, sign)));
+        }
+        int64_t lanes[2];
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(lanes), s);
+        int64_t sum = lanes[0]+lanes[1];
+        for(; t<nProducts; t++)
+            sum += int32_t(x[t])*int32_t(y[t]);
+        R[k] += sum;
+    }
+}
+#endif
+
+
+#if defined(ACF_AVX2)
+__attribute__((target("avx2")))
+static void
+acfAccumulateInt16Avx2(const int16_t* x, int nProducts,
+                       const int* lags, int nLags, int64_t* R) {
+    for(int k=0; k<nLags; k++) {
+        const int16_t* y = x+lags[k];
+        __m256i s0 = _mm256_setzero_si256();
+        __m256i s1 = _mm256_setzero_si256();
+        int t = 0;
+        for(; t+16<=nProducts; t+=16) {
+            __m256i p = _mm256_madd_epi16(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(x+t)),
+                                          _mm256_loadu_si256(reinterpret_cast<const __m256i*>(y+t)));
+            s0 = _mm256_add_epi64(s0, _mm256_cvtepi32_epi64(_mm256_castsi256_si128(p)));
+            s1 = _mm256_add_epi64(s1, _mm256_cvtepi32_epi64(_mm256_extracti128_si256(p, 1)));
+        }
+        int64_t lanes[4];
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(lanes), _mm256_add_epi64(s0, s1));
+        int64_t sum = lanes[0]+lanes[1]+lanes[2]+lanes[3];
+        for(; t<nProducts; t++)
+            sum += int32_t(x[t])*int32_t(y[t]);
+        R[k] += sum;
+    }
+}
+
+
+__attribute__((target("avx2,fma")))
+static void
+acfAccumulateAvx2(const float* x, int nProducts,
+                  const int* lags, int nLags, double* R) {
+    for(int k=0; k<nLags; k++) {
+        const float* y = x+lags[k];
+        __m256 s0 = _mm256_setzero_ps();
+        __m256 s1 = _mm256_setzero_ps();
+        int t = 0;
+        for(; t+16<=nProducts; t+=16) {
+            s0 = _mm256_fmadd_ps(_mm256_loadu_ps(x+t),   _mm256_loadu_ps(y+t),   s0);
+            s1 = _mm256_fmadd_ps(_mm256_loadu_ps(x+t+8), _mm256_loadu_ps(y+t+8), s1);
+        }
+        __m256 s = _mm256_add_ps(s0, s1);
+        __m128 h = _mm_add_ps(_mm256_castps256_ps128(s), _mm256_extractf128_ps(s, 1));
+        float lanes[4];
+        _mm_storeu_ps(lanes, h);
+        double sum = double(lanes[0])+double(lanes[1])+double(lanes[2])+double(lanes[3]);
+        for(; t<nProducts; t++)
+            sum += double(x[t]*y[t]);
+        R[k] += sum;
+    }
+}
+#endif
+
+
+#if defined(ACF_NEON)
+static void
+acfAccumulateNeon(const float* x, int nProducts,
+                  const int* lags, int nLags, double* R) {
+    for(int k=0; k<nLags; k++) {
+        const float* y = x+lags[k];
+        float32x4_t s0 = vdupq_n_f32(0.0f);
+        float32x4_t s1 = vdupq_n_f32(0.0f);
+        int t = 0;
+        for(; t+8<=nProducts; t+=8) {
+            s0 = vmlaq_f32(s0, vld1q_f32(x+t),   vld1q_f32(y+t));
+            s1 = vmlaq_f32(s1, vld1q_f32(x+t+4), vld1q_f32(y+t+4));
+        }
+        float lanes[4];
+        vst1q_f32(lanes, vaddq_f32(s0, s1));
+        double sum = double(lanes[0])+double(lanes[1])+double(lanes[2])+double(lanes[3]);
+        for(; t<nProducts; t++)
+            sum += double(x[t]*y[t]);
+        R[k] += sum;
+    }
+}
+#endif
+
+
+#if defined(ACF_NEON)
+// vmlal would accumulate the products in int32, which overflows after
+// two full scale products: vmull + vpadal sums them in int64 instead
+static void
+acfAccumulateInt16Neon(const int16_t* x, int nProducts,
+                       const int* lags, int nLags, int64_t* R) {
+    for(int k=0; k<nLags; k++) {
+        const int16_t* y = x+lags[k];
+        int64x2_t s0 = vdupq_n_s64(0);
+        int64x2_t s1 = vdupq_n_s64(0);
+        int t = 0;
+        for(; t+8<=nProducts; t+=8) {
+            int16x8_t a = vld1q_s16(x+t);
+            int16x8_t b = vld1q_s16(y+t);
+            s0 = vpadalq_s32(s0, vmull_s16(vget_low_s16(a),  vget_low_s16(b)));
+            s1 = vpadalq_s32(s1, vmull_s16(vget_high_s16(a), vget_high_s16(b)));
+        }
+        int64x2_t s = vaddq_s64(s0, s1);
+        int64_t sum = vgetq_lane_s64(s, 0)+vgetq_lane_s64(s, 1);
+        for(; t<nProducts; t++)
+            sum += int32_t(x[t])*int32_t(y[t]);
+        R[k] += sum;
+    }
+}
+#endif
+
+
+static AcfKernel
+selectKernel(const char** pName) {
+#if defined(ACF_AVX2)
+    __builtin_cpu_init();
+    if(__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma")) {
+        *pName = "avx2";
+        return acfAccumulateAvx2;
+    }
+#endif
+#if defined(ACF_X86)
+    *pName = "sse2";
+    return acfAccumulateSse2;
+#elif defined(ACF_NEON)
+    *pName = "neon";
+    return acfAccumulateNeon;
+#else
+    *pName = "scalar";
+    return acfAccumulateScalar;
+#endif
+}
+
+
+static AcfInt16Kernel
+selectInt16Kernel(const char** pName) {
+#if defined(ACF_AVX2)
+    __builtin_cpu_init();
+    if(__builtin_cpu_supports("avx2")) {
+        *pName = "int16 avx2";
+        return acfAccumulateInt16Avx2;
+    }
+#endif
+#if defined(ACF_X86)
+    *pName = "int16 sse2";
+    return acfAccumulateInt16Sse2;
+#elif defined(ACF_NEON)
+    *pName = "int16 neon";
+    return acfAccumulateInt16Neon;
+#else
+    *pName = "int16 scalar";
+    return acfAccumulateInt16Scalar;
+#endif
+}
+
+
+static const char* kernelName = nullptr;
+static const AcfKernel kernel = selectKernel(&kernelName);
+static const char* int16KernelName = nullptr;
+static const AcfInt16Kernel int16Kernel = selectInt16Kernel(&int16KernelName);
+
+
+void
+acfAccumulate(const float* x, int nProducts,
+              const int* lags, int nLags, double* R) {
+    kernel(x, nProducts, lags, nLags, R);
+}
+
+
+const char*
+acfKernelName() {
+    return kernelName;
+}
+
+
+void
+acfAccumulateInt16(const int16_t* x, int nProducts,
+                   const int* lags, int nLags, int64_t* R) {
+    int16Kernel(x, nProducts, lags, nLags, R);
+}
+
+
+const char*
+acfInt16KernelName() {
+    return int16KernelName;
+}
+
+
+// Every kernel of this build that the CPU can run, selected or not
+namespace {
+struct KernelEntry {
+    const char* name;
+    AcfKernel floatKernel;      // nullptr for the fixed point kernels...
+    AcfInt16Kernel int16Kernel; // ...and for the float ones
+};
+const int maxKernels = 6;
+
+
+int
+listKernels(KernelEntry* pEntries) {
+    int n = 0;
+    pEntries[n++] = {"scalar", acfAccumulateScalar, nullptr};
+    pEntries[n++] = {"int16 scalar", nullptr, acfAccumulateInt16Scalar};
+#if defined(ACF_X86)
+    pEntries[n++] = {"sse2", acfAccumulateSse2, nullptr};
+    pEntries[n++] = {"int16 sse2", nullptr, acfAccumulateInt16Sse2};
+#endif
+#if defined(ACF_AVX2)
+    __builtin_cpu_init();
+    if(__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma"))
+        pEntries[n++] = {"avx2", acfAccumulateAvx2, nullptr};
+    if(__builtin_cpu_supports("avx2"))
+        pEntries[n++] = {"int16 avx2", nullptr, acfAccumulateInt16Avx2};
+#endif
+#if defined(ACF_NEON)
+    pEntries[n++] = {"neon", acfAccumulateNeon, nullptr};
+    pEntries[n++] = {"int16 neon", nullptr, acfAccumulateInt16Neon};
+#endif
+    return n;
+}
+} // namespace
+
+
+static KernelEntry kernels[maxKernels];
+static const int nKernels = listKernels(kernels);
+
+
+int
+acfKernelCount() {
+    return nKernels;
+}
+
+
+const char*
+acfKernelNameAt(int index) {
+    return kernels[index].name;
+}
+
+
+// The largest relative error of the given kernels (either can be nullptr)
+// against the original double precision loop of MainWindow::OnBufferFull()
+// on a noisy tone, with nProducts products for every lag
+static double
+kernelError(AcfKernel floatKernel, AcfInt16Kernel int16Kernel, int nProducts) {
+    const int lags[] = {0, 1, 3, 7, 100, 367, 1024, 2047};
+    const int nLags = int(sizeof(lags)/sizeof(lags[0]));
+    const int nSamples = nProducts+lags[nLags-1];
+    std::vector<int16_t> samples(nSamples);
+    unsigned int seed = 12345;
+    for(int i=0; i<nSamples; i++) { // A noisy tone
+        seed = seed*1103515245u+12345u;
+        double noise = double((seed >> 16) & 0x7fff)/32768.0-0.5;
+        samples[i] = int16_t(16000.0*std::sin(0.05*i)+8000.0*noise);
+    }
+    std::vector<double> expected(nLags, 0.0);
+    for(int t=0; t<nProducts; t++) {
+        double ft = double(samples[t])/double(SHRT_MAX);
+        for(int tau=0; tau<nLags; tau++) {
+            double ftau = double(samples[t+lags[tau]])/double(SHRT_MAX);
+            expected[tau] += ft*ftau;
+        }
+    }
+    double maxError = 0.0;
+    if(floatKernel) {
+        std::vector<float> x(nSamples);
+        std::vector<double> R(nLags, 0.0);
+        acfToFloat(samples.data(), nSamples, x.data());
+        floatKernel(x.data(), nProducts, lags, nLags, R.data());
+        for(int k=0; k<nLags; k++)
+            maxError = std::max(maxError, std::fabs(R[k]-expected[k])/std::fabs(expected[0]));
+    }
+    if(int16Kernel) {
+        std::vector<int16_t> clamped(nSamples);
+        std::vector<int64_t> Ri(nLags, 0);
+        acfCopyInt16(samples.data(), nSamples, clamped.data());
+        int16Kernel(clamped.data(), nProducts, lags, nLags, Ri.data());
+        const double scale = 1.0/(double(SHRT_MAX)*double(SHRT_MAX));
+        for(int k=0; k<nLags; k++)
+            maxError = std::max(maxError, std::fabs(double(Ri[k])*scale-expected[k])/std::fabs(expected[0]));
+    }
+    return maxError;
+}
+
+
+double
+acfKernelError() {
+    return kernelError(kernel, int16Kernel, 2049);
+}
+
+
+// Block lengths that leave every possible tail of the vector loops
+double
+acfKernelError(int index) {
+    const int products[] = {1, 2, 3, 5, 7, 8, 9, 15, 16, 17, 31, 33, 100, 1001, 2049};
+    double maxError = 0.0;
+    for(int nProducts : products)
+        maxError = std::max(maxError, kernelError(kernels[index].floatKernel,
+                                                  kernels[index].int16Kernel,
+                                                  nProducts));
+    return maxError;
+}
@@ -0,0 +1,79 @@
+/*
+MIT License
+
+Copyright (c) 2022 salvato
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#pragma once
+
+#include <cstdint>
+
+
+// Autocorrelation kernels evaluated only at the given lags.
+// The vector implementation (AVX2 or SSE2 on x86, NEON on ARM)
+// is chosen at runtime; the scalar one is always available.
+
+// Converts nSamples int16 samples to float (divided by SHRT_MAX)
+void acfToFloat(const int16_t* pIn, int nSamples, float* pOut);
+
+// R[k] += Sum(t=0..nProducts-1) x[t]*x[t+lags[k]]   for k=0..nLags-1
+// x must hold at least nProducts + max(lags) samples
+void acfAccumulate(const float* x, int nProducts,
+                   const int* lags, int nLags, double* R);
+
+// Plain C++ version of acfAccumulate() (the reference implementation)
+void acfAccumulateScalar(const float* x, int nProducts,
+                         const int* lags, int nLags, double* R);
+
+// Name of the kernel selected at runtime ("avx2", "sse2", "neon", "scalar")
+const char* acfKernelName();
+
+// Fixed point version for the devices where the conversion to float and
+// the float arithmetic dominate: int16 x int16 products summed exactly
+// in int64 (NEON vmull/vpadal, SSE2 and AVX2 madd, or plain C++).
+// The samples must be in [-SHRT_MAX, SHRT_MAX]: see acfCopyInt16().
+// R[k] += Sum(t=0..nProducts-1) x[t]*x[t+lags[k]]   for k=0..nLags-1
+void acfAccumulateInt16(const int16_t* x, int nProducts,
+                        const int* lags, int nLags, int64_t* R);
+
+// Plain C++ version of acfAccumulateInt16()
+void acfAccumulateInt16Scalar(const int16_t* x, int nProducts,
+                              const int* lags, int nLags, int64_t* R);
+
+// Copies nSamples samples, replacing -32768 with -32767
+void acfCopyInt16(const int16_t* pIn, int nSamples, int16_t* pOut);
+
+// Name of the fixed point kernel selected at runtime
+const char* acfInt16KernelName();
+
+// Compares the selected kernels (float and fixed point) against the original
+// double precision loop on a pseudo random block.
+// Returns the largest relative error found.
+double acfKernelError();
+constexpr double acfKernelTolerance = 1.0e-5;
+
+// Every kernel this build can run on this CPU (the scalar ones included),
+// for the checks of NoteReplay --verify-kernels
+int acfKernelCount();
+const char* acfKernelNameAt(int index);
+
+// acfKernelError() of one of them, on blocks of many lengths
+double acfKernelError(int index);
@@ -0,0 +1,182 @@
+/*
+MIT License
+
+Copyright (c) 2022 salvato
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include "alloccheck.h"
+
+#if defined(NOTELEARN_ALLOC_CHECK)
+
+#include <cstddef>
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+
+
+namespace {
+thread_local int noAllocDepth = 0;
+
+
+void
+checkAllowed(std::size_t nBytes) {
+    if(noAllocDepth > 0) {
+        noAllocDepth = 0; // fprintf() may allocate
+        fprintf(stderr, "NoAllocScope: %zu bytes allocated in the real time path\n", nBytes);
+        abort();
+    }
+}
+
+
+void*
+checkedAlloc(std::size_t nBytes, std::size_t alignment) {
+    checkAllowed(nBytes);
+    if(nBytes == 0)
+        nBytes = 1;
+    void* p = nullptr;
+    if(alignment <= alignof(std::max_align_t))
+        p = malloc(nBytes);
+    else if(posix_memalign(&p, alignment, nBytes) != 0)
+        p = nullptr;
+    return p;
+}
+} // namespace
+
+
+NoAllocScope::NoAllocScope()
+    : bActive(true)
+{
+    noAllocDepth++;
+}
+
+
+NoAllocScope::~NoAllocScope() {
+    end();
+}
+
+
+void
+NoAllocScope::end() {
+    if(bActive) {
+        bActive = false;
+        noAllocDepth--;
+    }
+}
+
+
+// Every replaceable allocation function goes through checkedAlloc()
+void* operator new(std::size_t n) {
+    void* p = checkedAlloc(n, 0);
+    if(!p)
+        throw std::bad_alloc();
+    return p;
+}
+void* operator new[](std::size_t n) {
+    return operator new(n);
+}
+void* operator new(std::size_t n, std::align_val_t a) {
+    void* p = checkedAlloc(n, std::size_t(a));
+    if(!p)
+        throw std::bad_alloc();
+    return p;
+}
+void* operator new[](std::size_t n, std::align_val_t a) {
+    return operator new(n, a);
+}
+void* operator new(std::size_t n, const std::nothrow_t&) noexcept {
+    return checkedAlloc(n, 0);
+}
+void* operator new[](std::size_t n, const std::nothrow_t&) noexcept {
+    return checkedAlloc(n, 0);
+}
+void* operator new(std::size_t n, std::align_val_t a, const std::nothrow_t&) noexcept {
+    return checkedAlloc(n, std::size_t(a));
+}
+void* operator new[](std::size_t n, std::align_val_t a, const std::nothrow_t&) noexcept {
+    return checkedAlloc(n, std::size_t(a));
+}
+
+void operator delete(void* p) noexcept { free(p); }
+void operator delete[](void* p) noexcept { free(p); }
+void operator delete(void* p, std::size_t) noexcept { free(p); }
+void operator delete[](void* p, std::size_t) noexcept { free(p); }
+void operator delete(void* p, std::align_val_t) noexcept { free(p); }
+void operator delete[](void* p, std::align_val_t) noexcept { free(p); }
+void operator delete(void* p, std::size_t, std::align_val_t) noexcept { free(p); }
+void operator delete[](void* p, std::size_t, std::align_val_t) noexcept { free(p); }
+void operator delete(void* p, const std::nothrow_t&) noexcept { free(p); }
+void operator delete[](void* p, const std::nothrow_t&) noexcept { free(p); }
+void operator delete(void* p, std::align_val_t, const std::nothrow_t&) noexcept { free(p); }
+void operator delete[](void* p, std::align_val_t, const std::nothrow_t&) noexcept { free(p); }
+
+
+// The containers of Qt (QString, QByteArray, QList...) allocate with
+// malloc() from inside the Qt libraries: the C allocator is replaced
+// too. The definitions in the executable take the place of those of
+// the C library for every shared library, and forward to the entry
+// points that glibc exports for this purpose.
+#if defined(__GLIBC__)
+
+#include <cerrno>
+
+extern "C" {
+void* __libc_malloc(std::size_t nBytes);
+void* __libc_calloc(std::size_t n, std::size_t size);
+void* __libc_realloc(void* p, std::size_t nBytes);
+void* __libc_memalign(std::size_t alignment, std::size_t nBytes);
+void  __libc_free(void* p);
+
+void* malloc(std::size_t nBytes) noexcept {
+    checkAllowed(nBytes);
+    return __libc_malloc(nBytes);
+}
+void* calloc(std::size_t n, std::size_t size) noexcept {
+    checkAllowed(n*size);
+    return __libc_calloc(n, size);
+}
+void* realloc(void* p, std::size_t nBytes) noexcept {
+    checkAllowed(nBytes);
+    return __libc_realloc(p, nBytes);
+}
+void free(void* p) noexcept {
+    __libc_free(p);
+}
+void* memalign(std::size_t alignment, std::size_t nBytes) noexcept {
+    checkAllowed(nBytes);
+    return __libc_memalign(alignment, nBytes);
+}
+void* aligned_alloc(std::size_t alignment, std::size_t nBytes) noexcept {
+    checkAllowed(nBytes);
+    return __libc_memalign(alignment, nBytes);
+}
+int posix_memalign(void** pp, std::size_t alignment, std::size_t nBytes) noexcept {
+    checkAllowed(nBytes);
+    void* p = __libc_memalign(alignment, nBytes);
+    if(!p && nBytes)
+        return ENOMEM;
+    *pp = p;
+    return 0;
+}
+} // extern "C"
+
+#endif // __GLIBC__
+
+#endif // NOTELEARN_ALLOC_CHECK
@@ -0,0 +1,52 @@
+/*
+MIT License
+
+Copyright (c) 2022 salvato
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#pragma once
+
+
+// Debug mode for the real time path (qmake CONFIG+=alloc_check):
+// the global operator new (and, with glibc, malloc() and its family,
+// used by the Qt containers) is replaced and aborts the program, with a
+// message on stderr, when it is called by a thread inside a NoAllocScope.
+// NoteReplay --alloc-check verifies that the hook works.
+// Run under a debugger, the stack shows the culprit.
+// In normal builds NoAllocScope is empty and costs nothing.
+class NoAllocScope
+{
+public:
+#if defined(NOTELEARN_ALLOC_CHECK)
+    NoAllocScope();
+    ~NoAllocScope();
+    void end(); // Allocations are allowed again before the scope ends
+    static constexpr bool enabled = true;
+private:
+    bool bActive;
+#else
+    NoAllocScope() {}
+    void end() {}
+    static constexpr bool enabled = false;
+#endif
+    NoAllocScope(const NoAllocScope&) = delete;
+    NoAllocScope& operator=(const NoAllocScope&) = delete;
+};
@@ -0,0 +1,39 @@
+#MIT License
+
+#Copyright (c) 2022 salvato
+
+#Permission is hereby granted, free of charge, to any person obtaining a copy
+#of this software and associated documentation files (the "Software"), to deal
+#in the Software without restriction, including without limitation the rights
+#to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+#copies of the Software, and to permit persons to whom the Software is
+#furnished to do so, subject to the following conditions:
+
+#The above copyright notice and this permission notice shall be included in all
+#copies or substantial portions of the Software.
+
+#THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+#IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+#FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+#AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+#LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+#OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+#SOFTWARE.
+
+# Included by the projects linking the DSP core (see core.pro)
+
+INCLUDEPATH += $$PWD
+DEPENDPATH  += $$PWD
+
+CORE_LIB_DIR = $$shadowed($$PWD)
+win32 {
+    CONFIG(debug, debug|release): CORE_LIB_DIR = $$CORE_LIB_DIR/debug
+    else: CORE_LIB_DIR = $$CORE_LIB_DIR/release
+}
+LIBS += -L$$CORE_LIB_DIR -lnotelearncore
+
+# NoAllocScope must be the same in the library and in its users
+unix: alloc_check: DEFINES += NOTELEARN_ALLOC_CHECK
+
+win32:!win32-g++: PRE_TARGETDEPS += $$CORE_LIB_DIR/notelearncore.lib
+else: PRE_TARGETDEPS += $$CORE_LIB_DIR/libnotelearncore.a
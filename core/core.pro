@@ -0,0 +1,92 @@
+#MIT License
+
+#Copyright (c) 2022 salvato
+
+#Permission is hereby granted, free of charge, to any person obtaining a copy
+#of this software and associated documentation files (the "Software"), to deal
+#in the Software without restriction, including without limitation the rights
+#to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+#copies of the Software, and to permit persons to whom the Software is
+#furnished to do so, subject to the following conditions:
+
+#The above copyright notice and this permission notice shall be included in all
+#copies or substantial portions of the Software.
+
+#THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+#IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+#FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+#AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+#LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+#OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+#SOFTWARE.
+
+# The DSP core of NoteLearn as a static library: note tables, capture
+# buffer, signal gate, detectors and their worker. It needs only QtCore,
+# so the App, the benchmarks and the headless tools link the same code.
+
+QT = core
+
+TEMPLATE = lib
+CONFIG += staticlib c++17
+TARGET = notelearncore
+
+DEFINES += QT_DISABLE_DEPRECATED_BEFORE=0x060000    # disables all the APIs deprecated before Qt 6.0.0
+
+# The hot path is built with its own optimisation, whatever the UI uses:
+#   qmake CONFIG+=core_native    also tunes it for the building machine
+gcc|clang {
+    QMAKE_CXXFLAGS_RELEASE -= -O2
+    QMAKE_CXXFLAGS_RELEASE += -O3
+    core_native: QMAKE_CXXFLAGS += -march=native
+}
+
+# The original autocorrelation detector can run in fixed point (int16 x int16
+# products summed in int64) on the devices where float arithmetic is slow:
+#   qmake CONFIG+=acf_fixed_point
+# It can also be chosen at run time as "Autocorrelation (Lags, int16)".
+acf_fixed_point: DEFINES += ACF_FIXED_POINT
+
+# Debug mode of the real time path: the program aborts when the capture
+# or the detection allocate memory (see alloccheck.h). Unix only:
+#   qmake CONFIG+=alloc_check CONFIG+=debug
+unix: alloc_check: DEFINES += NOTELEARN_ALLOC_CHECK
+
+SOURCES += \
+    acfdetector.cpp \
+    acfkernel.cpp \
+    alloccheck.cpp \
+    decimator.cpp \
+    dsparena.cpp \
+    dspworker.cpp \
+    fft.cpp \
+    goertzeldetector.cpp \
+    iobuffer.cpp \
+    latencystats.cpp \
+    mpmdetector.cpp \
+    note.cpp \
+    pitchdetector.cpp \
+    polyphonicdetector.cpp \
+    shortwindowdetector.cpp \
+    signalgate.cpp \
+    yindetector.cpp
+
+HEADERS += \
+    acfdetector.h \
+    acfkernel.h \
+    alloccheck.h \
+    decimator.h \
+    dsparena.h \
+    dspworker.h \
+    fft.h \
+    goertzeldetector.h \
+    iobuffer.h \
+    latencystats.h \
+    latestvalue.h \
+    mpmdetector.h \
+    note.h \
+    noteDefinition.h \
+    pitchdetector.h \
+    polyphonicdetector.h \
+    shortwindowdetector.h \
+    signalgate.h \
+    yindetector.h
@@ -0,0 +1,120 @@
+/*
+MIT License
+
+Copyright (c) 2022 salvato
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include "decimator.h"
+
+#include <algorithm>
+#include <climits>
+#include <cmath>
+
+
+// Windowed sinc (Blackman) with the cutoff at 80% of the output Nyquist
+// frequency: at 12 kHz the pass band still holds the second harmonic
+// of the highest note in the table.
+Decimator::Decimator(int decimationFactor, int historySamples)
+    : M(std::max(1, decimationFactor))
+    , nTaps(16*M+1)
+    , h(nTaps)
+    , input(2*nTaps, 0.0f)
+    , inputPos(0)
+    , phase(0)
+    , nHistory(historySamples)
+    , output(2*historySamples, 0.0f)
+    , outputPos(0)
+{
+    const double pi = 3.14159265358979323846;
+    const double cutoff = 0.4/M; // In cycles per input sample
+    const int middle = nTaps/2;
+    double sum = 0.0;
+    for(int i=0; i<nTaps; i++) {
+        int n = i-middle;
+        double sinc = (n == 0) ? 2.0*cutoff : std::sin(2.0*pi*cutoff*n)/(pi*n);
+        double window = 0.42-0.5*std::cos(2.0*pi*i/(nTaps-1))+0.08*std::cos(4.0*pi*i/(nTaps-1));
+        h[i] = float(sinc*window);
+        sum += h[i];
+    }
+    for(int i=0; i<nTaps; i++) // Unity gain at DC
+        h[i] = float(h[i]/sum);
+}
+
+
+int
+Decimator::factor() const {
+    return M;
+}
+
+
+int
+Decimator::capacity() const {
+    return nHistory;
+}
+
+
+int
+Decimator::taps() const {
+    return nTaps;
+}
+
+
+void
+Decimator::reset() {
+    std::fill(input.begin(), input.end(), 0.0f);
+    std::fill(output.begin(), output.end(), 0.0f);
+    inputPos  = 0;
+    phase     = 0;
+    outputPos = 0;
+}
+
+
+int
+Decimator::push(const int16_t* pIn, int nSamples) {
+    const float scale = 1.0f/float(SHRT_MAX);
+    int nOut = 0;
+    for(int i=0; i<nSamples; i++) {
+        float sample = float(pIn[i])*scale;
+        input[inputPos]       = sample;
+        input[inputPos+nTaps] = sample;
+        inputPos = (inputPos+1 == nTaps) ? 0 : inputPos+1;
+        if(++phase < M)
+            continue;
+        phase = 0;
+        // The last nTaps inputs, oldest first (h is symmetric)
+        const float* pWindow = input.data()+inputPos;
+        float y = 0.0f;
+        for(int k=0; k<nTaps; k++)
+            y += h[k]*pWindow[k];
+        output[outputPos]          = y;
+        output[outputPos+nHistory] = y;
+        outputPos = (outputPos+1 == nHistory) ? 0 : outputPos+1;
+        nOut++;
+    }
+    return nOut;
+}
+
+
+const float*
+Decimator::latest(int nSamples) const {
+    nSamples = std::min(nSamples, nHistory);
+    return output.data()+outputPos+nHistory-nSamples;
+}
@@ -0,0 +1,58 @@
+/*
+MIT License
+
+Copyright (c) 2022 salvato
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+
+// Streaming low pass FIR decimator. Only one output every factor input
+// samples is computed (the cost of the polyphase form: nTaps/factor
+// multiplications per input sample). The outputs are kept in a mirrored
+// ring so that the latest ones can always be read as a single span.
+class Decimator
+{
+public:
+    Decimator(int decimationFactor, int historySamples);
+    int factor() const;
+    int capacity() const;
+    int taps() const;
+    void reset();
+    // Feeds int16 samples and returns the number of new outputs
+    int push(const int16_t* pIn, int nSamples);
+    // The last nSamples outputs (nSamples <= capacity())
+    const float* latest(int nSamples) const;
+
+private:
+    int M;
+    int nTaps;
+    std::vector<float> h;
+    std::vector<float> input;  // Mirrored ring of the last nTaps inputs
+    int inputPos;
+    int phase;
+    int nHistory;
+    std::vector<float> output; // Mirrored ring of the last nHistory outputs
+    int outputPos;
+};
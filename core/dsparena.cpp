@@ -22,43 +22,49 @@ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
 SOFTWARE.
 */
 
-#include "iobuffer.h"
-#include <QDebug>
+#include "dsparena.h"
 
+#include <cstdint>
+#include <cstring>
 
-IOBuffer::IOBuffer(char* buffer, int sampleNumber, QObject *parent)
-    : QIODevice(parent)
-    , pBuffer(buffer)
-    , sampleCount(sampleNumber)
+
+DspArena::DspArena()
+    : pStart(nullptr)
+    , nCapacity(0)
+    , nUsed(0)
 {
-    for(int i=0; i<sampleCount; i++)
-        pBuffer[i] = 0;
-    bufferStart = 0;
 }
 
 
-IOBuffer::~IOBuffer() {
+void
+DspArena::reserve(size_t nBytes) {
+    nBytes = (nBytes+alignment-1)/alignment*alignment;
+    block.reset(new unsigned char[nBytes+alignment]);
+    uintptr_t address = reinterpret_cast<uintptr_t>(block.get());
+    pStart    = block.get()+(alignment-address%alignment)%alignment;
+    nCapacity = nBytes;
+    nUsed     = 0;
+}
+
+
+size_t
+DspArena::capacity() const {
+    return nCapacity;
 }
 
 
-qint64
-IOBuffer::readData(char* pData, qint64 dataSize) {
-    Q_UNUSED(pData)
-    Q_UNUSED(dataSize)
-    return -1;
+size_t
+DspArena::used() const {
+    return nUsed;
 }
 
 
-qint64
-IOBuffer::writeData(const char* pData, qint64 dataSize) {
-    int start = 0;
-    if(dataSize < sampleCount) {
-        start = sampleCount-dataSize;
-        for(int s=0; s<start; ++s)
-            pBuffer[s] = pBuffer[s+dataSize];
-    }
-    for(int s=start; s<sampleCount; ++s, pData++)
-        pBuffer[s] =*pData;
-    emit bufferFull();
-    return dataSize;//(sampleCount-start);
+void*
+DspArena::takeBytes(size_t nBytes) {
+    if(nBytes > nCapacity-nUsed)
+        return nullptr;
+    unsigned char* p = pStart+nUsed;
+    nUsed += nBytes;
+    memset(p, 0, nBytes);
+    return p;
 }
@@ -0,0 +1,68 @@
+/*
+MIT License
+
+Copyright (c) 2022 salvato
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#pragma once
+
+#include <cstddef>
+#include <memory>
+
+
+// A single block of memory, reserved before the audio starts, from which
+// the workspace buffers are taken. Nothing is given back until the next
+// reserve(): while audio flows the allocator is never called.
+// Every buffer is aligned to a cache line (and so to any SIMD register).
+class DspArena
+{
+public:
+    static const size_t alignment = 64;
+
+    DspArena();
+    DspArena(const DspArena&) = delete;
+    DspArena& operator=(const DspArena&) = delete;
+    // Frees the previous block: the buffers taken from it become invalid
+    void reserve(size_t nBytes);
+    size_t capacity() const;
+    size_t used() const;
+
+    // The bytes to reserve for n values of T (with their alignment)
+    template<typename T>
+    static constexpr size_t bytesFor(size_t n) {
+        return (n*sizeof(T)+alignment-1)/alignment*alignment;
+    }
+
+    // n zeroed values of T, nullptr when the arena is full
+    template<typename T>
+    T* take(size_t n) {
+        return static_cast<T*>(takeBytes(bytesFor<T>(n)));
+    }
+
+protected:
+    void* takeBytes(size_t nBytes);
+
+private:
+    std::unique_ptr<unsigned char[]> block;
+    unsigned char* pStart; // block aligned to a cache line
+    size_t nCapacity;
+    size_t nUsed;
+};
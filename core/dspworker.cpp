@@ -0,0 +1,481 @@
+/*
+MIT License
+
+Copyright (c) 2022 salvato
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include "dspworker.h"
+#include "acfkernel.h"
+#include "alloccheck.h"
+#include "acfdetector.h"
+#include "yindetector.h"
+#include "mpmdetector.h"
+#include "shortwindowdetector.h"
+#include "goertzeldetector.h"
+#include "polyphonicdetector.h"
+#include "decimator.h"
+#include <QThreadPool>
+
+
+// The kernels are selected once per process: so is their check
+static double
+selectedKernelError() {
+    static const double error = acfKernelError();
+    return error;
+}
+
+
+DspWorker::DspWorker(IOBuffer* pInputBuffer,
+                     const std::vector<Note>& noteTable,
+                     int rate,
+                     int window)
+    : QObject()
+    , pBuffer(pInputBuffer)
+    , notes(noteTable)
+    , sampleRate(rate)
+    , windowSamples(window)
+    , currentFactor(0)
+    , pDecimator(nullptr)
+    , pDetectors(nullptr)
+    , pShortDetector(nullptr)
+    , pCurrentDetector(nullptr)
+    , lastEnd(0)
+    , gate(rate)
+    , pStats(nullptr)
+    , gateEnd(0)
+    , nMaxWindow(0)
+    , data(nullptr)
+    , samples(nullptr)
+    , detectorIndex(0)
+    , targetNote(-1)
+    , candidates(0)
+    , decimation(1)
+    , bLowLatency(false)
+    , threshold(5.0)
+    , noiseOffset(-1.0)
+    , floorSeed(-1.0)
+    , floor(0.0)
+    , bActive(false)
+    , bProcessPending(false)
+    , pPool(nullptr)
+    , nPoolRequests(0)
+    , level(0.0)
+    , bGateOpen(false)
+{
+    // The vector kernel must match the original double precision loop
+    // (every kernel is checked by NoteReplay --verify-kernels)
+    Q_ASSERT(selectedKernelError() < acfKernelTolerance);
+
+    // Products per block of the original detector (at the full rate)
+    referenceProducts = windowSamples-int((double)sampleRate/notes[0].frequency+0.5);
+    buildDetectors();
+    selectDetectors(1);
+    gateEnd = pBuffer->samplesWritten();
+}
+
+
+DspWorker::~DspWorker() {
+    deleteDetectors();
+}
+
+
+void
+DspWorker::deleteDetectors() {
+    for(DetectorSet& set : sets) {
+        for(PitchDetector* pDetector : set.detectors)
+            delete pDetector;
+        set.detectors.clear();
+        delete set.pShortDetector;
+        set.pShortDetector = nullptr;
+        delete set.pDecimator;
+        set.pDecimator = nullptr;
+    }
+    pDetectors = nullptr;
+    pShortDetector = nullptr;
+    pDecimator = nullptr;
+    pCurrentDetector = nullptr;
+}
+
+
+// The detectors (and their lag tables) are built for the rate of
+// every (possibly decimated) signal, with the workspace of the
+// full rate blocks
+void
+DspWorker::buildDetectors() {
+    deleteDetectors();
+    int nSamples = 0;
+    for(int i=0; i<nFactors; i++) {
+        int factor = 1 << i;
+        int rate   = sampleRate/factor;
+        int window = windowSamples/factor;
+        DetectorSet& set = sets[i];
+        for(int kind=0; kind<nDetectorKinds; kind++)
+            set.detectors.push_back(newDetector(kind, notes, rate, window));
+        // Windows of three periods of the target note
+        set.pShortDetector = new ShortWindowDetector(notes, rate,
+                                                     notes[NoteTable::firstGuitarNote].frequency*0.97,
+                                                     notes.back().frequency*1.03,
+                                                     3);
+        int nSetSamples = set.pShortDetector->maxWindowSamples();
+        for(PitchDetector* pDetector : set.detectors)
+            nSetSamples = qMax(nSetSamples, pDetector->maxWindowSamples());
+        if(factor > 1)
+            set.pDecimator = new Decimator(factor, nSetSamples);
+        else
+            nSamples = nSetSamples;
+    }
+    nMaxWindow = nSamples;
+    arena.reserve(DspArena::bytesFor<float>(nSamples)+DspArena::bytesFor<int16_t>(nSamples));
+    data    = arena.take<float>(nSamples);
+    samples = arena.take<int16_t>(nSamples);
+}
+
+
+// Called by the worker when the decimation changes: only pointers move
+void
+DspWorker::selectDetectors(int factor) {
+    int i = factor == 4 ? 2 : factor-1;
+    currentFactor    = factor;
+    pDetectors       = sets[i].detectors.data();
+    pShortDetector   = sets[i].pShortDetector;
+    pDecimator       = sets[i].pDecimator;
+    pCurrentDetector = nullptr;
+    if(pDecimator)
+        pDecimator->reset();
+    lastEnd = pBuffer->samplesWritten();
+}
+
+
+// The selectable detectors, in the order of the Detector ComboBox.
+// window is the analysis window of the original detector at this rate.
+PitchDetector*
+DspWorker::newDetector(int index, const std::vector<Note>& notes, int rate, int window) {
+    // YIN and MPM only search the guitar range (E2 up to the last note)
+    double minFrequency = notes[NoteTable::firstGuitarNote].frequency*0.97;
+    double maxFrequency = notes.back().frequency*1.03;
+#if defined(ACF_FIXED_POINT) // Build time choice for the devices with a slow FPU
+    const AcfDetector::Engine originalEngine = AcfDetector::SparseLagsInt16;
+#else
+    const AcfDetector::Engine originalEngine = AcfDetector::SparseLags;
+#endif
+    switch(index) {
+        case 0:  return new AcfDetector(notes, rate, window, originalEngine);
+        case 1:  return new AcfDetector(notes, rate, window, AcfDetector::FullFft);
+        case 2:  return new AcfDetector(notes, rate, window, AcfDetector::Sliding);
+        case 3:  return new YinDetector(notes, rate, minFrequency, maxFrequency);
+        case 4:  return new MpmDetector(notes, rate, minFrequency, maxFrequency);
+        case 5:  return new GoertzelDetector(notes, rate, window);
+        case 6:  return new PolyphonicDetector(notes, rate);
+        case 7:  return new AcfDetector(notes, rate, window, AcfDetector::SparseLagsInt16);
+        default: return nullptr;
+    }
+}
+
+
+int
+DspWorker::detectorCount() const {
+    return nDetectorKinds;
+}
+
+
+int
+DspWorker::defaultWindowSamples(int sampleRate) {
+    return int(sampleRate*chunkSeconds)/int(sizeof(int16_t));
+}
+
+
+// From 6dB (index 0, shown as 9) to 22dB (index 8, shown as 1)
+double
+DspWorker::sensitivityOffset(int index) {
+    return 6.0+2.0*index;
+}
+
+
+// The full rate detectors read their window in place from the ring
+// (the decimator only the new samples): the writer must never reach
+// these samples while a block is being processed
+int
+DspWorker::maxWindowSamples() const {
+    return nMaxWindow;
+}
+
+
+const char*
+DspWorker::detectorName(int index) const {
+    return sets[0].detectors.at(index)->name();
+}
+
+
+// More than 1 for the detectors that can hear chords
+int
+DspWorker::detectorPolyphony(int index) const {
+    return sets[0].detectors.at(index)->maxPolyphony();
+}
+
+
+void
+DspWorker::setDetector(int index) {
+    if(index < 0 || index >= detectorCount())
+        index = 0;
+    detectorIndex.store(index, std::memory_order_relaxed);
+}
+
+
+// The threshold is the energy R[0] of one block of the original
+// autocorrelation detector: every detector gets it per sample.
+void
+DspWorker::setThreshold(double newThreshold) {
+    threshold.store(newThreshold, std::memory_order_relaxed);
+}
+
+
+// With an offset (in dB, >= 0) the threshold follows the noise floor
+// of the input, the fixed threshold becoming its minimum
+void
+DspWorker::setNoiseOffset(double dB) {
+    noiseOffset.store(dB, std::memory_order_relaxed);
+}
+
+
+// The floor learned on the device in a previous session
+void
+DspWorker::setNoiseFloor(double meanSquare) {
+    floorSeed.store(meanSquare, std::memory_order_relaxed);
+}
+
+
+double
+DspWorker::noiseFloor() const {
+    return floor.load(std::memory_order_relaxed);
+}
+
+
+// In low latency mode the selected detector is replaced by
+// the short window one, centered on the target note
+void
+DspWorker::setLowLatency(bool bNewLowLatency) {
+    bLowLatency.store(bNewLowLatency, std::memory_order_relaxed);
+}
+
+
+void
+DspWorker::setTargetNote(int note) {
+    targetNote.store(note, std::memory_order_relaxed);
+}
+
+
+// Both ends in a single atomic, so that the worker never sees half a change
+void
+DspWorker::setCandidates(int firstNote, int lastNote) {
+    candidates.store(firstNote*256+lastNote, std::memory_order_relaxed);
+}
+
+
+// The detectors can run on a decimated signal: 1 (48 kHz),
+// 2 (24 kHz) or 4 (12 kHz). They are rebuilt by the worker.
+void
+DspWorker::setDecimation(int factor) {
+    if(factor != 1 && factor != 2 && factor != 4)
+        factor = 1;
+    decimation.store(factor, std::memory_order_relaxed);
+}
+
+
+void
+DspWorker::setActive(bool bNewActive) {
+    bActive.store(bNewActive, std::memory_order_release);
+}
+
+
+// Must be set before the worker thread is started
+void
+DspWorker::setLatencyStats(LatencyStats* pLatencyStats) {
+    pStats = pLatencyStats;
+}
+
+
+// Called by the UI thread when resultReady() has been received
+bool
+DspWorker::takeResult(PitchEstimate* pResult) {
+    return result.take(pResult);
+}
+
+
+// Mean square value of the last 10ms of input (for the level meter)
+double
+DspWorker::inputLevel() const {
+    return level.load(std::memory_order_relaxed);
+}
+
+
+bool
+DspWorker::isGateOpen() const {
+    return bGateOpen.load(std::memory_order_relaxed);
+}
+
+
+// The worker is not moved to a thread of its own: process() runs on
+// the pool, never on two pool threads at the same time.
+// To be called before the first write.
+void
+DspWorker::setThreadPool(QThreadPool* pThreadPool) {
+    pPool = pThreadPool;
+}
+
+
+// Runs in the thread of the audio writer (Qt::DirectConnection).
+// Bursts of writes are coalesced into a single queued process()
+// (or a single pooled task).
+void
+DspWorker::onBufferFull() {
+    if(!bActive.load(std::memory_order_acquire))
+        return;
+    if(pPool) {
+        if(nPoolRequests.fetch_add(1, std::memory_order_acq_rel) == 0)
+            pPool->start([this]() { runPooled(); });
+        return;
+    }
+    if(!bProcessPending.exchange(true, std::memory_order_acq_rel))
+        QMetaObject::invokeMethod(this, "process", Qt::QueuedConnection);
+}
+
+
+// The writes arrived while processing are served by the same task
+void
+DspWorker::runPooled() {
+    int nSeen;
+    do {
+        nSeen = nPoolRequests.load(std::memory_order_acquire);
+        process();
+    } while(nPoolRequests.fetch_sub(nSeen, std::memory_order_acq_rel) != nSeen);
+    emit idle();
+}
+
+
+void
+DspWorker::process() {
+    bProcessPending.store(false, std::memory_order_release);
+    if(!bActive.load(std::memory_order_acquire))
+        return;
+    NoAllocScope noAlloc; // Up to the publication of the result
+    int64_t startTime   = LatencyStats::now();
+    int64_t captureTime = pBuffer->lastWriteTime();
+    if(pStats)
+        pStats->record(LatencyStats::Queue, startTime-captureTime);
+
+    int factor = decimation.load(std::memory_order_relaxed);
+    if(factor != currentFactor)
+        selectDetectors(factor);
+
+    PitchDetector* pDetector = pDetectors[detectorIndex.load(std::memory_order_relaxed)];
+    if(bLowLatency.load(std::memory_order_relaxed))
+        pDetector = pShortDetector;
+    if(pDetector != pCurrentDetector) {
+        pCurrentDetector = pDetector;
+        pDetector->reset();
+    }
+    pDetector->setTargetNote(targetNote.load(std::memory_order_relaxed));
+    int range = candidates.load(std::memory_order_relaxed);
+    pDetector->setCandidates(range/256, range%256);
+    double meanSquare = threshold.load(std::memory_order_relaxed)/referenceProducts;
+
+    // The gate sees every new sample: the detector (and the decimator)
+    // only run while it is open, so silence costs almost nothing
+    IOBuffer::View view;
+    pBuffer->samplesSince(gateEnd, pBuffer->capacity(), &view);
+    gateEnd = view.end;
+    gate.setThreshold(meanSquare);
+    gate.setNoiseOffset(noiseOffset.load(std::memory_order_relaxed));
+    double seed = floorSeed.exchange(-1.0, std::memory_order_relaxed);
+    if(seed >= 0.0)
+        gate.setNoiseFloor(seed);
+    bool bWasOpen = gate.isOpen();
+    gate.push(view.first, view.firstCount);
+    bool bOpen = gate.push(view.second, view.secondCount);
+    pDetector->setThreshold(gate.currentThreshold());
+    level.store(gate.level(), std::memory_order_relaxed);
+    floor.store(gate.noiseFloor(), std::memory_order_relaxed);
+    bGateOpen.store(bOpen, std::memory_order_relaxed);
+    if(!bOpen) {
+        if(bWasOpen)
+            pDetector->reset();
+        return;
+    }
+    if(gate.takeOnset()) // A new pluck: forget the previous one
+        pDetector->reset();
+
+    const float* x = nullptr;
+    const int16_t* x16 = nullptr;
+    int nSamples;
+    int nNewSamples;
+    if(pDecimator) {
+        // The samples written since the last call go through the decimator
+        int maxFeed = qMin(pBuffer->capacity(), (pDecimator->capacity()+pDecimator->taps())*factor);
+        int nFeed = pBuffer->samplesSince(lastEnd, maxFeed, &view);
+        if(view.end-lastEnd > nFeed) // Some samples were lost
+            pDecimator->reset();
+        lastEnd = view.end;
+        int nOut = pDecimator->push(view.first, view.firstCount);
+        nOut    += pDecimator->push(view.second, view.secondCount);
+        nSamples    = pDetector->windowSamples();
+        nNewSamples = qMin(nOut, nSamples);
+        x = pDecimator->latest(nSamples);
+    }
+    else {
+        // The latest samples (one or two spans) are converted to float
+        // only once, straight from the ring. The fixed point detectors
+        // get a contiguous copy of the int16 samples instead.
+        nSamples = pBuffer->latestSamples(pDetector->windowSamples(), &view);
+        if(pDetector->acceptsInt16()) {
+            acfCopyInt16(view.first,  view.firstCount,  samples);
+            acfCopyInt16(view.second, view.secondCount, samples+view.firstCount);
+            x16 = samples;
+        }
+        else {
+            acfToFloat(view.first,  view.firstCount,  data);
+            acfToFloat(view.second, view.secondCount, data+view.firstCount);
+            x = data;
+        }
+        // Samples not seen by the previous call
+        nNewSamples = int(qMin(view.end-lastEnd, qint64(nSamples)));
+        lastEnd = view.end;
+    }
+
+    PitchEstimate estimate;
+    estimate.nNotes = 0;
+    bool bDetected = x16 ? pDetector->processInt16(x16, nSamples, nNewSamples, &estimate)
+                         : pDetector->process(x, nSamples, nNewSamples, &estimate);
+    int64_t endTime = LatencyStats::now();
+    if(pStats)
+        pStats->record(LatencyStats::Detect, endTime-startTime);
+    if(bDetected) {
+        if(estimate.nNotes == 0) { // A single note detector
+            estimate.nNotes   = 1;
+            estimate.notes[0] = estimate.note;
+        }
+        estimate.captureTime = captureTime;
+        estimate.publishTime = endTime;
+        bool bNew = result.publish(estimate);
+        noAlloc.end(); // The queued connection posts an event
+        if(bNew)
+            emit resultReady();
+    }
+}
@@ -0,0 +1,151 @@
+/*
+MIT License
+
+Copyright (c) 2022 salvato
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#pragma once
+
+#include "note.h"
+#include "iobuffer.h"
+#include "latestvalue.h"
+#include "pitchdetector.h"
+#include "signalgate.h"
+#include "latencystats.h"
+#include "dsparena.h"
+#include <QObject>
+#include <atomic>
+#include <vector>
+
+
+class ShortWindowDetector;
+class Decimator;
+class QThreadPool;
+
+
+// Owns the pitch detectors and runs the detection on its own thread,
+// so that the UI (resize, repaint, popups) never delays it.
+// The results are published through a coalescing LatestValue channel.
+// Many workers (one per input device) can share a thread pool instead.
+class DspWorker : public QObject
+{
+    Q_OBJECT
+public:
+    explicit DspWorker(IOBuffer* pInputBuffer,
+                       const std::vector<Note>& notes,
+                       int sampleRate,
+                       int windowSamples);
+    ~DspWorker();
+    static const int nDetectorKinds = 8;
+    // The audio chunk of the App: 0.3 s worth of bytes (0.15 s of mono
+    // int16 samples) is both the analysis window and the audio write
+    static constexpr double chunkSeconds = 0.3;
+    static int defaultWindowSamples(int sampleRate);
+    // The fixed threshold of the App (about -60dB): the minimum of the
+    // one that follows the noise floor of the input
+    static constexpr double defaultThreshold = 0.01;
+    // The Sensitivity ComboBoxes of the App: the noise offset of every
+    // index, and the index of the default offset (14dB)
+    static double sensitivityOffset(int index);
+    static constexpr int defaultSensitivity = 4;
+    static PitchDetector* newDetector(int index, const std::vector<Note>& notes,
+                                      int sampleRate, int windowSamples);
+    int detectorCount() const;
+    int maxWindowSamples() const;
+    const char* detectorName(int index) const;
+    int detectorPolyphony(int index) const;
+    void setDetector(int index);
+    void setThreshold(double newThreshold);
+    void setNoiseOffset(double dB);
+    void setNoiseFloor(double meanSquare);
+    void setLowLatency(bool bLowLatency);
+    void setTargetNote(int note);
+    void setCandidates(int firstNote, int lastNote);
+    void setDecimation(int factor);
+    void setActive(bool bActive);
+    void setLatencyStats(LatencyStats* pLatencyStats);
+    void setThreadPool(QThreadPool* pThreadPool);
+    bool takeResult(PitchEstimate* pResult);
+    double inputLevel() const;
+    bool isGateOpen() const;
+    double noiseFloor() const;
+
+signals:
+    void resultReady();
+    void idle(); // With a thread pool: every write has been processed
+
+public slots:
+    void onBufferFull();
+
+private slots:
+    void process();
+
+protected:
+    void runPooled();
+    void buildDetectors();
+    void selectDetectors(int factor);
+    void deleteDetectors();
+
+private:
+    IOBuffer* pBuffer;
+    std::vector<Note> notes;
+    int sampleRate;
+    int windowSamples;
+    int referenceProducts;
+    // The detectors (and the decimator) of every decimation factor
+    // are built with the worker: changing the rate allocates nothing
+    struct DetectorSet {
+        std::vector<PitchDetector*> detectors;
+        ShortWindowDetector* pShortDetector = nullptr;
+        Decimator* pDecimator = nullptr; // None at the full rate
+    };
+    static const int nFactors = 3; // 1, 2 and 4
+    DetectorSet sets[nFactors];
+    int currentFactor;
+    Decimator* pDecimator;
+    PitchDetector* const* pDetectors;
+    ShortWindowDetector* pShortDetector;
+    PitchDetector* pCurrentDetector;
+    qint64 lastEnd;
+    SignalGate gate;
+    LatencyStats* pStats;
+    qint64 gateEnd;
+    DspArena arena;  // The block workspace, sized with the detectors
+    int nMaxWindow;  // The most samples read in place from the ring
+    float* data;
+    int16_t* samples; // For the fixed point detectors
+    std::atomic<int> detectorIndex;
+    std::atomic<int> targetNote;
+    std::atomic<int> candidates; // firstNote*256 + lastNote
+    std::atomic<int> decimation;
+    std::atomic<bool> bLowLatency;
+    std::atomic<double> threshold;
+    std::atomic<double> noiseOffset;
+    std::atomic<double> floorSeed; // Negative when already applied
+    std::atomic<double> floor;
+    std::atomic<bool> bActive;
+    std::atomic<bool> bProcessPending;
+    QThreadPool* pPool;
+    std::atomic<int> nPoolRequests; // Writes since the pooled task started
+    LatestValue<PitchEstimate> result;
+    std::atomic<double> level;
+    std::atomic<bool> bGateOpen;
+};
@@ -0,0 +1,172 @@
+/*
+MIT License
+
+Copyright (c) 2022 salvato
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include "fft.h"
+
+#include <cmath>
+#include <cstring>
+
+
+RealFft::RealFft(int fftSize)
+    : n(fftSize)
+    , half(fftSize/2)
+{
+    const double pi = 3.14159265358979323846;
+    int nBits = 0;
+    while((1 << nBits) < half)
+        nBits++;
+    bitReverse.resize(half);
+    for(int i=0; i<half; i++) {
+        int r = 0;
+        for(int b=0; b<nBits; b++)
+            if(i & (1 << b)) r |= 1 << (nBits-1-b);
+        bitReverse[i] = r;
+    }
+    twiddle.resize(half/2);
+    for(int k=0; k<half/2; k++)
+        twiddle[k] = std::polar(1.0, -2.0*pi*k/half);
+    realTwiddle.resize(half+1);
+    for(int k=0; k<=half; k++)
+        realTwiddle[k] = std::polar(1.0, -2.0*pi*k/n);
+    work.resize(half);
+}
+
+
+int
+RealFft::size() const {
+    return n;
+}
+
+
+// In place iterative radix-2 transform of size half
+void
+RealFft::transform(std::complex<float>* z, bool bInverse) const {
+    for(int i=0; i<half; i++) {
+        int j = bitReverse[i];
+        if(j > i) std::swap(z[i], z[j]);
+    }
+    for(int len=2; len<=half; len<<=1) {
+        int step = half/len;
+        for(int start=0; start<half; start+=len) {
+            for(int k=0; k<len/2; k++) {
+                std::complex<float> w = twiddle[k*step];
+                if(bInverse) w = std::conj(w);
+                std::complex<float> a = z[start+k];
+                std::complex<float> b = z[start+k+len/2]*w;
+                z[start+k]       = a+b;
+                z[start+k+len/2] = a-b;
+            }
+        }
+    }
+}
+
+
+void
+RealFft::forward(const float* in, std::complex<float>* out) {
+    // Even samples in the real part, odd samples in the imaginary one
+    for(int i=0; i<half; i++)
+        work[i] = std::complex<float>(in[2*i], in[2*i+1]);
+    transform(work.data(), false);
+    const std::complex<float> I(0.0f, 1.0f);
+    for(int k=0; k<=half; k++) {
+        std::complex<float> zk  = work[k % half];
+        std::complex<float> zmk = std::conj(work[(half-k) % half]);
+        std::complex<float> even = 0.5f*(zk+zmk);
+        std::complex<float> odd  = -0.5f*I*(zk-zmk);
+        out[k] = even+realTwiddle[k]*odd;
+    }
+}
+
+
+void
+RealFft::inverse(const std::complex<float>* in, float* out) {
+    const std::complex<float> I(0.0f, 1.0f);
+    for(int k=0; k<half; k++) {
+        std::complex<float> xk  = in[k];
+        std::complex<float> xmk = std::conj(in[half-k]);
+        std::complex<float> even = 0.5f*(xk+xmk);
+        std::complex<float> odd  = 0.5f*(xk-xmk)*std::conj(realTwiddle[k]);
+        work[k] = even+I*odd;
+    }
+    transform(work.data(), true);
+    const float scale = 1.0f/float(half);
+    for(int i=0; i<half; i++) {
+        out[2*i]   = work[i].real()*scale;
+        out[2*i+1] = work[i].imag()*scale;
+    }
+}
+
+
+FftAutocorrelation::FftAutocorrelation()
+    : nSamples(0)
+    , pFft(nullptr)
+{
+}
+
+
+FftAutocorrelation::~FftAutocorrelation() {
+    delete pFft;
+}
+
+
+// Builds the plan (and the buffers) for blocks of nNewSamples:
+// called before the audio starts, compute() allocates nothing
+void
+FftAutocorrelation::prepare(int nNewSamples) {
+    if(nNewSamples == nSamples && pFft)
+        return;
+    nSamples = nNewSamples;
+    int fftSize = 4;
+    while(fftSize < nSamples)
+        fftSize <<= 1;
+    delete pFft;
+    pFft = new RealFft(fftSize);
+    padded.assign(fftSize, 0.0f);
+    r.assign(fftSize, 0.0f);
+    A.resize(fftSize/2+1);
+    B.resize(fftSize/2+1);
+}
+
+
+// The correlation of x[0..nProducts-1] with x[0..nSamples-1] is computed
+// as IFFT(conj(A)*B). No circular aliasing occurs for lags up to
+// nSamples-nProducts when the FFT size is at least nSamples.
+// Returns nullptr when there are no products to sum.
+const float*
+FftAutocorrelation::compute(const float* x, int nNewSamples, int nProducts) {
+    if(nProducts <= 0 || nProducts > nNewSamples)
+        return nullptr;
+    if(nNewSamples != nSamples) // A new block size
+        prepare(nNewSamples);
+    const int fftSize = pFft->size();
+    memcpy(padded.data(), x, size_t(nProducts)*sizeof(float));
+    std::fill(padded.begin()+nProducts, padded.end(), 0.0f);
+    pFft->forward(padded.data(), A.data());
+    memcpy(padded.data()+nProducts, x+nProducts, size_t(nSamples-nProducts)*sizeof(float));
+    pFft->forward(padded.data(), B.data());
+    for(int k=0; k<=fftSize/2; k++)
+        B[k] *= std::conj(A[k]);
+    pFft->inverse(B.data(), r.data());
+    return r.data();
+}
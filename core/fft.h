@@ -0,0 +1,80 @@
+/*
+MIT License
+
+Copyright (c) 2022 salvato
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#pragma once
+
+#include <complex>
+#include <vector>
+
+
+// Radix-2 FFT of real data, computed through a complex FFT of half size.
+// The plan (twiddles and bit reversal table) is built once per size.
+class RealFft
+{
+public:
+    explicit RealFft(int fftSize); // fftSize must be a power of 2 (>= 4)
+    int size() const;
+    // in: size() samples, out: size()/2+1 bins
+    void forward(const float* in, std::complex<float>* out);
+    // in: size()/2+1 bins, out: size() samples (already divided by size())
+    void inverse(const std::complex<float>* in, float* out);
+
+protected:
+    void transform(std::complex<float>* z, bool bInverse) const;
+
+private:
+    int n;
+    int half;
+    std::vector<int> bitReverse;
+    std::vector<std::complex<float>> twiddle;     // exp(-2*pi*i*k/half)
+    std::vector<std::complex<float>> realTwiddle; // exp(-2*pi*i*k/n)
+    std::vector<std::complex<float>> work;
+};
+
+
+// Full autocorrelation through the Wiener-Khinchin theorem.
+// The plan is cached and rebuilt only when the block size changes;
+// all the buffers are reused between blocks.
+class FftAutocorrelation
+{
+public:
+    FftAutocorrelation();
+    ~FftAutocorrelation();
+    FftAutocorrelation(const FftAutocorrelation&) = delete;
+    FftAutocorrelation& operator=(const FftAutocorrelation&) = delete;
+    // Builds the plan and the buffers for blocks of nSamples
+    void prepare(int nSamples);
+    // r[lag] = Sum(t=0..nProducts-1) x[t]*x[t+lag]   for lag=0..nSamples-nProducts
+    // (the same definition used by acfAccumulate()). Returns a pointer to r,
+    // or nullptr when nProducts is not in [1, nSamples].
+    const float* compute(const float* x, int nSamples, int nProducts);
+
+private:
+    int nSamples;
+    RealFft* pFft;
+    std::vector<float> padded;
+    std::vector<float> r;
+    std::vector<std::complex<float>> A;
+    std::vector<std::complex<float>> B;
+};
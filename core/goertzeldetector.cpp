@@ -0,0 +1,146 @@
+/*
+MIT License
+
+Copyright (c) 2022 salvato
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include "goertzeldetector.h"
+#include "acfkernel.h"
+
+#include <algorithm>
+#include <cmath>
+
+
+GoertzelDetector::GoertzelDetector(const std::vector<Note>& notes, int sampleRate,
+                                   int hopSamples)
+    : PitchDetector(notes, sampleRate)
+    , nWindow(hopSamples)
+    , first(0)
+    , nCandidates(0)
+    , coefficient(maxCandidates*nHarmonics, 0.0f)
+    , s1(maxCandidates*nHarmonics, 0.0f)
+    , s2(maxCandidates*nHarmonics, 0.0f)
+    , score(maxCandidates, 0.0)
+{
+}
+
+
+const char*
+GoertzelDetector::name() const {
+    return "Goertzel (string notes)";
+}
+
+
+int
+GoertzelDetector::windowSamples() const {
+    return nWindow;
+}
+
+
+void
+GoertzelDetector::setCandidates(int firstNote, int lastNote) {
+    firstNote = std::max(0, firstNote);
+    lastNote  = std::min(int(frequencies.size()), lastNote);
+    int nNew  = std::min(maxCandidates, lastNote-firstNote);
+    if(firstNote == first && nNew == nCandidates)
+        return;
+    first = firstNote;
+    nCandidates = std::max(0, nNew);
+    if(nCandidates == 0)
+        return;
+    const double pi = 3.14159265358979323846;
+    for(int c=0; c<nCandidates; c++) {
+        for(int h=0; h<nHarmonics; h++) {
+            double omega = 2.0*pi*(h+1)*frequencies[first+c]/sampleRate;
+            coefficient[c*nHarmonics+h] = float(2.0*std::cos(omega));
+        }
+    }
+    PitchDetector::reset();
+}
+
+
+bool
+GoertzelDetector::process(const float* x, int nSamples, int nNewSamples, PitchEstimate* pEstimate) {
+    (void)nNewSamples;
+    if(nCandidates == 0 || nSamples < nWindow)
+        return false;
+    x += nSamples-nWindow;
+    // The energy first (with the selected ACF kernel): nothing else
+    // to do in the silence
+    const int zeroLag = 0;
+    double energy = 0.0;
+    acfAccumulate(x, nWindow, &zeroLag, 1, &energy);
+    energy /= nWindow;
+    if(energy < threshold) {
+        PitchDetector::reset();
+        return false;
+    }
+    // Two samples per step: the two states of every resonator swap
+    // their roles instead of being copied
+    const int nFilters = nCandidates*nHarmonics;
+    std::fill(s1.begin(), s1.end(), 0.0f);
+    std::fill(s2.begin(), s2.end(), 0.0f);
+    float* pS1 = s1.data();
+    float* pS2 = s2.data();
+    const float* pCoefficient = coefficient.data();
+    int t = 0;
+    for(; t+1<nWindow; t+=2) {
+        const float x0 = x[t];
+        const float x1 = x[t+1];
+        for(int f=0; f<nFilters; f++) { // Vectorized across the resonators
+            pS2[f] = x0+pCoefficient[f]*pS1[f]-pS2[f];
+            pS1[f] = x1+pCoefficient[f]*pS2[f]-pS1[f];
+        }
+    }
+    if(t < nWindow) { // An odd window: the last state goes in s1
+        for(int f=0; f<nFilters; f++) {
+            float s = x[t]+pCoefficient[f]*pS1[f]-pS2[f];
+            pS2[f] = pS1[f];
+            pS1[f] = s;
+        }
+    }
+    // The note a fifth (or a fourth) above the played one shares one of
+    // its harmonics, but its own fundamental is not in the signal: the
+    // power of the harmonics is weighted by the one of the fundamental
+    double total = 0.0;
+    int best = 0;
+    for(int c=0; c<nCandidates; c++) {
+        double power[nHarmonics];
+        double harmonics = 0.0;
+        for(int h=0; h<nHarmonics; h++) {
+            int f = c*nHarmonics+h;
+            power[h] = double(s1[f])*s1[f]+double(s2[f])*s2[f]-double(coefficient[f])*s1[f]*s2[f];
+            harmonics += power[h];
+        }
+        score[c] = power[0]*harmonics;
+        total += score[c];
+        if(score[c] > score[best])
+            best = c;
+    }
+    int note = first+best;
+    if(!isStable(note))
+        return false;
+    pEstimate->note       = note;
+    pEstimate->frequency  = frequencies[note];
+    pEstimate->confidence = total > 0.0 ? score[best]/total : 0.0;
+    pEstimate->energy     = energy;
+    return true;
+}
@@ -0,0 +1,56 @@
+/*
+MIT License
+
+Copyright (c) 2022 salvato
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#pragma once
+
+#include "pitchdetector.h"
+
+
+// A bank of Goertzel resonators tuned to the first three harmonics
+// of the notes playable on the selected string only. Notes outside
+// the string range can never be reported. The window is one hop of
+// the audio: less than a DFT bin separates the lowest semitones, but
+// their harmonics are further apart.
+class GoertzelDetector : public PitchDetector
+{
+public:
+    GoertzelDetector(const std::vector<Note>& notes, int sampleRate,
+                     int hopSamples);
+    const char* name() const override;
+    int windowSamples() const override;
+    bool process(const float* x, int nSamples, int nNewSamples, PitchEstimate* pEstimate) override;
+    void setCandidates(int firstNote, int lastNote) override;
+
+private:
+    static constexpr int maxCandidates = 24;
+    static constexpr int nHarmonics = 3;
+    int nWindow;
+    int first;
+    int nCandidates;
+    // One resonator for every (candidate, harmonic) pair
+    std::vector<float> coefficient;
+    std::vector<float> s1;
+    std::vector<float> s2;
+    std::vector<double> score;
+};
@@ -0,0 +1,198 @@
+/*
+MIT License
+
+Copyright (c) 2022 salvato
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include "iobuffer.h"
+#include "alloccheck.h"
+#include "latencystats.h"
+#include <QDebug>
+#include <cstring>
+
+
+// The ring size is rounded up to a power of two
+// so that positions can be wrapped with a mask.
+IOBuffer::IOBuffer(int sampleNumber, QObject *parent)
+    : QIODevice(parent)
+    , ringSize(1)
+    , writePos(0)
+    , readPos(0)
+    , nOverruns(0)
+    , lastWrite(0)
+    , pStats(nullptr)
+    , halfSample(0)
+    , bHalfSample(false)
+{
+    while(ringSize < sampleNumber)
+        ringSize <<= 1;
+    ringMask = ringSize-1;
+    ring.assign(ringSize, 0); // The ring starts filled with silence
+}
+
+
+IOBuffer::~IOBuffer() {
+}
+
+
+int
+IOBuffer::capacity() const {
+    return ringSize;
+}
+
+
+// Grows the ring to at least sampleNumber samples:
+// must be called before the audio source is started
+void
+IOBuffer::reserve(int sampleNumber) {
+    if(sampleNumber <= ringSize)
+        return;
+    while(ringSize < sampleNumber)
+        ringSize <<= 1;
+    ringMask = ringSize-1;
+    ring.assign(ringSize, 0);
+}
+
+
+qint64
+IOBuffer::samplesWritten() const {
+    return writePos.load(std::memory_order_acquire);
+}
+
+
+// Number of times the writer has overwritten
+// samples not yet seen by the reader.
+quint64
+IOBuffer::overruns() const {
+    return nOverruns.load(std::memory_order_relaxed);
+}
+
+
+// Must be set before the audio source is started
+void
+IOBuffer::setLatencyStats(LatencyStats* pLatencyStats) {
+    pStats = pLatencyStats;
+}
+
+
+// When the newest samples have been received
+int64_t
+IOBuffer::lastWriteTime() const {
+    return lastWrite.load(std::memory_order_acquire);
+}
+
+
+qint64
+IOBuffer::readData(char* pData, qint64 dataSize) {
+    Q_UNUSED(pData)
+    Q_UNUSED(dataSize)
+    return -1;
+}
+
+
+// Only the new bytes are copied: the work is O(dataSize)
+// whatever the size of the analysis window.
+qint64
+IOBuffer::writeData(const char* pData, qint64 dataSize) {
+    NoAllocScope noAlloc;
+    int64_t startTime = LatencyStats::now();
+    int64_t previousWrite = lastWrite.exchange(startTime, std::memory_order_release);
+    qint64 nBytes = dataSize;
+    if(bHalfSample && nBytes > 0) { // Complete the sample split by the previous write
+        char sample[sizeof(int16_t)] = {halfSample, *pData};
+        pushSamples(sample, 1);
+        bHalfSample = false;
+        pData++;
+        nBytes--;
+    }
+    qint64 nSamples = nBytes/qint64(sizeof(int16_t));
+    pushSamples(pData, nSamples);
+    if(nBytes % qint64(sizeof(int16_t))) {
+        halfSample = pData[nBytes-1];
+        bHalfSample = true;
+    }
+    noAlloc.end(); // The queued connections post an event
+    emit bufferFull();
+    if(pStats) {
+        pStats->record(LatencyStats::WriteData, LatencyStats::now()-startTime);
+        const int64_t oneSecond = 1000000000;
+        if(previousWrite > 0 && startTime-previousWrite < oneSecond) // Not a Stop/Start pause
+            pStats->record(LatencyStats::WriteInterval, startTime-previousWrite);
+    }
+    return dataSize;
+}
+
+
+void
+IOBuffer::pushSamples(const char* pBytes, qint64 nSamples) {
+    if(nSamples <= 0) return;
+    qint64 head = writePos.load(std::memory_order_relaxed);
+    if(head+nSamples-readPos.load(std::memory_order_acquire) > ringSize)
+        nOverruns.fetch_add(1, std::memory_order_relaxed);
+    qint64 newHead = head+nSamples;
+    if(nSamples > ringSize) { // Only the last ringSize samples can survive
+        pBytes += (nSamples-ringSize)*qint64(sizeof(int16_t));
+        head = newHead-ringSize;
+        nSamples = ringSize;
+    }
+    int start  = int(head & ringMask);
+    int nFirst = int(qMin(nSamples, qint64(ringSize-start)));
+    memcpy(ring.data()+start, pBytes, size_t(nFirst)*sizeof(int16_t));
+    memcpy(ring.data(), pBytes+nFirst*qint64(sizeof(int16_t)), size_t(nSamples-nFirst)*sizeof(int16_t));
+    writePos.store(newHead, std::memory_order_release);
+}
+
+
+// Returns a view of the last nSamples written (at most capacity()).
+// Before the ring has been filled the oldest samples are silence.
+// The view stays valid until the writer wraps around the ring.
+int
+IOBuffer::latestSamples(int nSamples, View* pView) {
+    nSamples = qMin(nSamples, ringSize);
+    qint64 tail  = writePos.load(std::memory_order_acquire);
+    int start    = int((tail-nSamples) & ringMask);
+    int nFirst   = qMin(nSamples, ringSize-start);
+    pView->first       = ring.data()+start;
+    pView->firstCount  = nFirst;
+    pView->second      = ring.data();
+    pView->secondCount = nSamples-nFirst;
+    pView->end         = tail;
+    readPos.store(tail, std::memory_order_release);
+    return nSamples;
+}
+
+
+// Returns a view of the samples written after the given stream position
+// (at most maxSamples of them: the most recent ones).
+int
+IOBuffer::samplesSince(qint64 position, int maxSamples, View* pView) {
+    qint64 tail = writePos.load(std::memory_order_acquire);
+    qint64 nSamples = qBound(qint64(0), tail-position, qint64(qMin(maxSamples, ringSize)));
+    int start  = int((tail-nSamples) & ringMask);
+    int nFirst = int(qMin(nSamples, qint64(ringSize-start)));
+    pView->first       = ring.data()+start;
+    pView->firstCount  = nFirst;
+    pView->second      = ring.data();
+    pView->secondCount = int(nSamples)-nFirst;
+    pView->end         = tail;
+    readPos.store(tail, std::memory_order_release);
+    return int(nSamples);
+}
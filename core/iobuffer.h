@@ -0,0 +1,85 @@
+/*
+MIT License
+
+Copyright (c) 2022 salvato
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#pragma once
+
+#include <QIODevice>
+#include <QObject>
+#include <atomic>
+#include <vector>
+#include <cstdint>
+
+
+class LatencyStats;
+
+
+// Single-producer/single-consumer ring of int16 samples.
+// The audio backend is the only writer (writeData) and the
+// detector the only reader (latestSamples): no locks are needed.
+class IOBuffer : public QIODevice
+{
+    Q_OBJECT
+public:
+    // Zero-copy view of the ring: the second span is used only
+    // when the requested samples wrap around the ring end.
+    struct View {
+        const int16_t* first;
+        int firstCount;
+        const int16_t* second;
+        int secondCount;
+        qint64 end; // Stream position just after the last sample
+    };
+
+public:
+    explicit IOBuffer(int sampleNumber, QObject *parent = nullptr);
+    ~IOBuffer();
+    int capacity() const;
+    void reserve(int sampleNumber);
+    qint64 samplesWritten() const;
+    quint64 overruns() const;
+    void setLatencyStats(LatencyStats* pLatencyStats);
+    int64_t lastWriteTime() const;
+    int latestSamples(int nSamples, View* pView);
+    int samplesSince(qint64 position, int maxSamples, View* pView);
+
+signals:
+    void bufferFull();
+
+protected:
+    qint64 readData(char* pData, qint64 dataSize) override;
+    qint64 writeData(const char* pData, qint64 dataSize) override;
+    void pushSamples(const char* pBytes, qint64 nSamples);
+
+private:
+    std::vector<int16_t> ring;
+    int ringSize;
+    qint64 ringMask;
+    std::atomic<qint64> writePos; // Total samples written (producer)
+    std::atomic<qint64> readPos;  // Write position seen by the last read (consumer)
+    std::atomic<quint64> nOverruns;
+    std::atomic<int64_t> lastWrite; // LatencyStats::now() of the last write
+    LatencyStats* pStats;
+    char halfSample;
+    bool bHalfSample;
+};
@@ -0,0 +1,165 @@
+/*
+MIT License
+
+Copyright (c) 2022 salvato
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include "latencystats.h"
+
+#include <QFile>
+#include <QTextStream>
+#include <chrono>
+#include <cmath>
+
+
+LatencyHistogram::LatencyHistogram() {
+    reset();
+}
+
+
+// Only relaxed atomic increments: it can be called from the audio thread
+void
+LatencyHistogram::record(int64_t nanoseconds) {
+    double microseconds = double(nanoseconds)*1.0e-3;
+    int bucket = 0;
+    if(microseconds >= 1.0)
+        bucket = qMin(nBuckets-1, 1+int(4.0*std::log2(microseconds)));
+    buckets[bucket].fetch_add(1, std::memory_order_relaxed);
+    nSamples.fetch_add(1, std::memory_order_relaxed);
+    int64_t previous = maxNanoseconds.load(std::memory_order_relaxed);
+    while(nanoseconds > previous &&
+          !maxNanoseconds.compare_exchange_weak(previous, nanoseconds, std::memory_order_relaxed));
+}
+
+
+void
+LatencyHistogram::reset() {
+    for(int i=0; i<nBuckets; i++)
+        buckets[i].store(0, std::memory_order_relaxed);
+    nSamples.store(0, std::memory_order_relaxed);
+    maxNanoseconds.store(0, std::memory_order_relaxed);
+}
+
+
+quint64
+LatencyHistogram::count() const {
+    return nSamples.load(std::memory_order_relaxed);
+}
+
+
+double
+LatencyHistogram::maxMicroseconds() const {
+    return double(maxNanoseconds.load(std::memory_order_relaxed))*1.0e-3;
+}
+
+
+double
+LatencyHistogram::percentile(double fraction) const {
+    quint64 total = 0;
+    for(int i=0; i<nBuckets; i++)
+        total += buckets[i].load(std::memory_order_relaxed);
+    if(total == 0)
+        return 0.0;
+    quint64 rank = quint64(std::ceil(fraction*double(total)));
+    quint64 sum = 0;
+    for(int i=0; i<nBuckets; i++) {
+        sum += buckets[i].load(std::memory_order_relaxed);
+        if(sum >= rank)
+            return std::exp2(i/4.0);
+    }
+    return maxMicroseconds();
+}
+
+
+int64_t
+LatencyStats::now() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+               std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+
+const char*
+LatencyStats::stageName(int stage) {
+    static const char* names[nStages] = {
+        "Write interval",
+        "writeData()",
+        "Queue to worker",
+        "Detector",
+        "Delivery to UI",
+        "Score repaint",
+        "End to end"
+    };
+    return (stage >= 0 && stage < nStages) ? names[stage] : "";
+}
+
+
+void
+LatencyStats::record(Stage stage, int64_t nanoseconds) {
+    histograms[stage].record(nanoseconds);
+}
+
+
+const LatencyHistogram&
+LatencyStats::histogram(int stage) const {
+    return histograms[stage];
+}
+
+
+void
+LatencyStats::reset() {
+    for(LatencyHistogram& histogram : histograms)
+        histogram.reset();
+}
+
+
+// One line per stage, times in milliseconds
+QString
+LatencyStats::report() const {
+    QString sReport = QString("%1 %2 %3 %4 %5 %6\n")
+                          .arg("Stage", -16)
+                          .arg("Count", 8)
+                          .arg("p50", 9)
+                          .arg("p95", 9)
+                          .arg("p99", 9)
+                          .arg("max", 9);
+    for(int i=0; i<nStages; i++) {
+        const LatencyHistogram& h = histograms[i];
+        sReport += QString("%1 %2 %3 %4 %5 %6\n")
+                       .arg(stageName(i), -16)
+                       .arg(h.count(), 8)
+                       .arg(h.percentile(0.50)*1.0e-3, 9, 'f', 3)
+                       .arg(h.percentile(0.95)*1.0e-3, 9, 'f', 3)
+                       .arg(h.percentile(0.99)*1.0e-3, 9, 'f', 3)
+                       .arg(h.maxMicroseconds()*1.0e-3, 9, 'f', 3);
+    }
+    return sReport;
+}
+
+
+bool
+LatencyStats::dump(const QString& fileName, const QString& sHeader) const {
+    QFile file(fileName);
+    if(!file.open(QIODevice::WriteOnly | QIODevice::Text))
+        return false;
+    QTextStream stream(&file);
+    stream << sHeader << "\n" << "Times in ms\n" << report();
+    return true;
+}
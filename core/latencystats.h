@@ -0,0 +1,83 @@
+/*
+MIT License
+
+Copyright (c) 2022 salvato
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#pragma once
+
+#include <QString>
+#include <atomic>
+#include <cstdint>
+
+
+// Lock-free histogram of durations: any thread can record() while
+// another one reads the percentiles. Buckets are a quarter of octave
+// wide, from 1 microsecond to about 50 minutes.
+class LatencyHistogram
+{
+public:
+    LatencyHistogram();
+    void record(int64_t nanoseconds);
+    void reset();
+    quint64 count() const;
+    double maxMicroseconds() const;
+    // Upper edge of the bucket holding the given fraction of the samples
+    double percentile(double fraction) const;
+
+private:
+    static const int nBuckets = 128;
+    std::atomic<quint64> buckets[nBuckets];
+    std::atomic<quint64> nSamples;
+    std::atomic<int64_t> maxNanoseconds;
+};
+
+
+// Timing of every stage of the path from the audio backend to the
+// score label: the write interval of the device, IOBuffer::writeData(),
+// the queue to the worker thread, the detector, the delivery to the UI
+// thread, the repaint of the label and the whole path end to end.
+class LatencyStats
+{
+public:
+    enum Stage {
+        WriteInterval,
+        WriteData,
+        Queue,
+        Detect,
+        Deliver,
+        Paint,
+        EndToEnd,
+        nStages
+    };
+
+public:
+    static int64_t now(); // Monotonic clock (ns)
+    static const char* stageName(int stage);
+    void record(Stage stage, int64_t nanoseconds);
+    const LatencyHistogram& histogram(int stage) const;
+    void reset();
+    QString report() const;
+    bool dump(const QString& fileName, const QString& sHeader) const;
+
+private:
+    LatencyHistogram histograms[nStages];
+};
@@ -0,0 +1,71 @@
+/*
+MIT License
+
+Copyright (c) 2022 salvato
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#pragma once
+
+#include <atomic>
+
+
+// Lock-free "latest value" channel between one producer and one consumer
+// (a triple buffer). The producer never waits and the consumer only ever
+// sees the most recent value: intermediate values are coalesced.
+template<typename T>
+class LatestValue
+{
+public:
+    LatestValue()
+        : middle(1)
+        , notifyPending(false)
+        , back(0)
+        , front(2)
+    {
+    }
+
+    // Producer side. Returns true when the consumer must be notified,
+    // i.e. when no notification is already pending.
+    bool publish(const T& value) {
+        slot[back] = value;
+        back = middle.exchange(back | freshBit, std::memory_order_acq_rel) & indexMask;
+        return !notifyPending.exchange(true, std::memory_order_acq_rel);
+    }
+
+    // Consumer side. Returns false if nothing newer has been published.
+    bool take(T* pValue) {
+        notifyPending.store(false, std::memory_order_release);
+        if(!(middle.load(std::memory_order_acquire) & freshBit))
+            return false;
+        front = middle.exchange(front, std::memory_order_acq_rel) & indexMask;
+        *pValue = slot[front];
+        return true;
+    }
+
+private:
+    static constexpr int indexMask = 3;
+    static constexpr int freshBit  = 4;
+    T slot[3];
+    std::atomic<int> middle;
+    std::atomic<bool> notifyPending;
+    int back;  // Owned by the producer
+    int front; // Owned by the consumer
+};
@@ -0,0 +1,138 @@
+/*
+MIT License
+
+Copyright (c) 2022 salvato
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include "mpmdetector.h"
+#include "acfkernel.h"
+
+#include <algorithm>
+#include <cmath>
+
+
+MpmDetector::MpmDetector(const std::vector<Note>& notes, int sampleRate,
+                         double minFrequency, double maxFrequency)
+    : PitchDetector(notes, sampleRate)
+    , k(0.93)
+    , minClarity(0.6)
+{
+    tauCapacity    = int(std::ceil(sampleRate/minFrequency))+1;
+    windowCapacity = tauCapacity;
+    lags.resize(tauCapacity+1);
+    for(int tau=0; tau<=tauCapacity; tau++)
+        lags[tau] = tau;
+    r.assign(tauCapacity+1, 0.0);
+    nsdf.assign(tauCapacity+1, 0.0);
+    keyMaxima.reserve(tauCapacity);
+    configure(int(std::floor(sampleRate/maxFrequency)), tauCapacity, tauCapacity);
+}
+
+
+// Lag range and integration window (within the allocated capacity)
+void
+MpmDetector::configure(int newTauMin, int newTauMax, int newW) {
+    tauMax = std::max(3, std::min(newTauMax, tauCapacity));
+    tauMin = std::max(2, std::min(newTauMin, tauMax-1));
+    W      = std::max(1, std::min(newW, windowCapacity));
+}
+
+
+const char*
+MpmDetector::name() const {
+    return "McLeod (MPM)";
+}
+
+
+int
+MpmDetector::windowSamples() const {
+    return W+tauMax;
+}
+
+
+int
+MpmDetector::maxWindowSamples() const {
+    return windowCapacity+tauCapacity;
+}
+
+
+bool
+MpmDetector::process(const float* x, int nSamples, int nNewSamples, PitchEstimate* pEstimate) {
+    (void)nNewSamples;
+    if(nSamples < windowSamples())
+        return false;
+    std::fill(r.begin(), r.end(), 0.0);
+    acfAccumulate(x, W, lags.data(), tauMax+1, r.data());
+    const double e0 = r[0];
+    if(e0/W < threshold) {
+        PitchDetector::reset();
+        return false;
+    }
+    // nsdf(tau) = 2r(tau) / (e(0) + e(tau))
+    double eTau = e0;
+    nsdf[0] = 1.0;
+    for(int tau=1; tau<=tauMax; tau++) {
+        eTau += double(x[tau+W-1])*x[tau+W-1]-double(x[tau-1])*x[tau-1];
+        double m = e0+eTau;
+        nsdf[tau] = m > 0.0 ? 2.0*r[tau]/m : 0.0;
+    }
+    // One key maximum for every positive lobe after the first zero crossing
+    keyMaxima.clear();
+    int tau = 1;
+    while(tau < tauMax && nsdf[tau] > 0.0)
+        tau++;
+    double nMax = 0.0;
+    while(tau < tauMax) {
+        while(tau < tauMax && nsdf[tau] <= 0.0)
+            tau++;
+        int peak = -1;
+        while(tau < tauMax && nsdf[tau] > 0.0) {
+            if(peak < 0 || nsdf[tau] > nsdf[peak])
+                peak = tau;
+            tau++;
+        }
+        if(peak >= tauMin) {
+            keyMaxima.push_back(peak);
+            nMax = std::max(nMax, nsdf[peak]);
+        }
+    }
+    if(keyMaxima.empty() || nMax < minClarity) { // Unvoiced
+        PitchDetector::reset();
+        return false;
+    }
+    int best = keyMaxima.front();
+    for(int peak : keyMaxima) {
+        if(nsdf[peak] >= k*nMax) {
+            best = peak;
+            break;
+        }
+    }
+    double period = best+parabolicOffset(nsdf[best-1], nsdf[best], nsdf[best+1]);
+    double frequency = double(sampleRate)/period;
+    int note = noteFromFrequency(frequency);
+    if(!isStable(note))
+        return false;
+    pEstimate->note       = note;
+    pEstimate->frequency  = frequency;
+    pEstimate->confidence = std::min(1.0, nsdf[best]);
+    pEstimate->energy     = e0/W;
+    return true;
+}
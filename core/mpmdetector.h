@@ -0,0 +1,59 @@
+/*
+MIT License
+
+Copyright (c) 2022 salvato
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#pragma once
+
+#include "pitchdetector.h"
+
+
+// McLeod Pitch Method (McLeod and Wyvill, 2005): the first key maximum
+// of the normalized square difference function close to the highest one.
+class MpmDetector : public PitchDetector
+{
+public:
+    MpmDetector(const std::vector<Note>& notes, int sampleRate,
+                double minFrequency, double maxFrequency);
+    const char* name() const override;
+    int windowSamples() const override;
+    int maxWindowSamples() const override;
+    bool process(const float* x, int nSamples, int nNewSamples, PitchEstimate* pEstimate) override;
+
+protected:
+    void configure(int newTauMin, int newTauMax, int newW);
+
+protected:
+    int tauCapacity;    // Buffers are allocated once for these sizes
+    int windowCapacity;
+    int tauMin;
+    int tauMax;
+    int W; // Integration window
+
+private:
+    double k;            // Fraction of the highest key maximum to accept
+    double minClarity;   // Below this the block is unvoiced
+    std::vector<int> lags;
+    std::vector<double> r;    // Autocorrelation at lags 0..tauMax
+    std::vector<double> nsdf; // Normalized square difference function
+    std::vector<int> keyMaxima;
+};
@@ -0,0 +1,82 @@
+/*
+MIT License
+
+Copyright (c) 2022 salvato
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include "note.h"
+
+
+namespace NoteTable {
+
+static constexpr std::array<std::array<char, nameSize>, nNotes> names = makeNames();
+
+const char*
+name(int id) {
+    return names[id].data();
+}
+
+
+// The capture rates (and their decimations) built by the compiler
+const int*
+precomputedLags(int sampleRate) {
+    switch(sampleRate) {
+        case 48000: return Lags<48000>::table.data();
+        case 44100: return Lags<44100>::table.data();
+        case 24000: return Lags<24000>::table.data();
+        case 22050: return Lags<22050>::table.data();
+        case 12000: return Lags<12000>::table.data();
+        case 11025: return Lags<11025>::table.data();
+        default:    return nullptr;
+    }
+}
+
+} // namespace NoteTable
+
+
+Note::Note()
+    : id(0)
+    , frequency(0.0)
+{
+}
+
+
+Note::Note(NoteTable::NoteId noteId, double f)
+    : id(noteId)
+    , frequency(f)
+{
+}
+
+
+QString
+Note::name() const {
+    return QString::fromLatin1(NoteTable::name(id));
+}
+
+
+std::vector<Note>
+equalTemperament(double a4Frequency) {
+    std::vector<Note> notes;
+    notes.reserve(NoteTable::nNotes);
+    for(int id=0; id<NoteTable::nNotes; id++)
+        notes.push_back(Note(NoteTable::NoteId(id), NoteTable::frequency(id, a4Frequency)));
+    return notes;
+}
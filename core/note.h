@@ -23,15 +23,23 @@ SOFTWARE.
 */
 
 #pragma once
+#include "noteDefinition.h"
+
 #include <QString>
+#include <vector>
 
 
 class Note
 {
 public:
     Note();
-    Note(QString name, double f);
-    QString sname;
+    Note(NoteTable::NoteId noteId, double f);
+    QString name() const;
+    NoteTable::NoteId id;
     double frequency;
 };
 
+
+// The notes table of the App tuned with the given A4
+std::vector<Note> equalTemperament(double a4Frequency = NoteTable::defaultA4Frequency);
+
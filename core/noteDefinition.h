@@ -0,0 +1,143 @@
+/*
+MIT License
+
+Copyright (c) 2022 salvato
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#pragma once
+
+#include <array>
+#include <cstdint>
+
+
+// The notes of the App, from C0 to D6 (the last fret of the e string
+// on a Stratocaster), generated at compile time from equal temperament.
+// A note is identified by its index in the table: C0 is 0, A4 is 57.
+namespace NoteTable {
+
+typedef uint8_t NoteId;
+
+constexpr int nNotes = 75;
+constexpr NoteId a4 = 57;
+constexpr double defaultA4Frequency = 440.0;
+
+
+// 2^(semitones/12): octaves are exact, the rest is made of
+// products of 2^(1/12) (std::pow is not constexpr)
+constexpr double
+semitoneRatio(int semitones) {
+    int octaves = semitones >= 0 ? semitones/12 : -((11-semitones)/12);
+    int rest = semitones-12*octaves;
+    double ratio = 1.0;
+    for(int i=0; i<rest; i++)
+        ratio *= 1.0594630943592952646;
+    for(int i=0; i<octaves; i++)
+        ratio *= 2.0;
+    for(int i=0; i<-octaves; i++)
+        ratio *= 0.5;
+    return ratio;
+}
+
+
+constexpr double
+frequency(int id, double a4Frequency = defaultA4Frequency) {
+    return a4Frequency*semitoneRatio(id-a4);
+}
+
+
+// Autocorrelation lag (in samples) of the period of the note
+constexpr int
+lag(int id, int sampleRate, double a4Frequency = defaultA4Frequency) {
+    return int(double(sampleRate)/frequency(id, a4Frequency)+0.5);
+}
+
+
+constexpr std::array<int, nNotes>
+makeLags(int sampleRate, double a4Frequency = defaultA4Frequency) {
+    std::array<int, nNotes> lags {};
+    for(int id=0; id<nNotes; id++)
+        lags[id] = lag(id, sampleRate, a4Frequency);
+    return lags;
+}
+
+
+// The lags of the common sample rates (with A4 = 440 Hz) are built by the compiler
+template<int SampleRate>
+struct Lags {
+    static constexpr std::array<int, nNotes> table = makeLags(SampleRate);
+};
+
+static_assert(Lags<48000>::table[a4] == 109, "A4 lasts 109.09 samples at 48 kHz");
+static_assert(Lags<44100>::table[a4] == 100, "A4 lasts 100.23 samples at 44.1 kHz");
+
+// The table of the given rate, or nullptr if it has not been built
+const int* precomputedLags(int sampleRate);
+
+
+// Names as "C#4/Db4", in a static table
+constexpr int nameSize = 8;
+
+constexpr std::array<std::array<char, nameSize>, nNotes>
+makeNames() {
+    const char sharps[12] = {'C', 'C', 'D', 'D', 'E', 'F', 'F', 'G', 'G', 'A', 'A', 'B'};
+    const char flats[12]  = {' ', 'D', ' ', 'E', ' ', ' ', 'G', ' ', 'A', ' ', 'B', ' '};
+    std::array<std::array<char, nameSize>, nNotes> names {};
+    for(int id=0; id<nNotes; id++) {
+        int pitch = id % 12;
+        char octave = char('0'+id/12);
+        std::array<char, nameSize>& name = names[id];
+        int n = 0;
+        name[n++] = sharps[pitch];
+        if(flats[pitch] != ' ') {
+            name[n++] = '#';
+            name[n++] = octave;
+            name[n++] = '/';
+            name[n++] = flats[pitch];
+            name[n++] = 'b';
+        }
+        name[n++] = octave;
+        name[n] = '\0';
+    }
+    return names;
+}
+
+const char* name(int id);
+
+
+// The guitar in standard tuning. The exercises of a string (and the
+// candidates of the detectors) are its first nFrets frets.
+constexpr int nStrings = 6;
+constexpr int nFrets = 12; // 22 on a Stratocaster
+constexpr std::array<NoteId, nStrings> stringStart = {29, 34, 39, 44, 48, 53}; // First fret
+constexpr NoteId firstGuitarNote = 28; // E2, the open low E string
+constexpr NoteId lastGuitarNote  = 64; // E5, the 12th fret of the e string
+
+static_assert(stringStart[0] == firstGuitarNote+1, "The first fret of the low E string is F2");
+static_assert(stringStart[nStrings-1]+nFrets-1 == lastGuitarNote, "The 12th fret of the e string is E5");
+
+// The octave base of the staff for the exercises of a string, shared
+// by the main and the classroom windows. The B string (from C4) gets
+// one octave less than the others: Da controllare !!! (-2 ?)
+constexpr int staffOctaveBase(int string) {
+    return stringStart[string]/12 - (string == 4 ? 1 : 2);
+}
+
+} // namespace NoteTable
@@ -0,0 +1,146 @@
+/*
+MIT License
+
+Copyright (c) 2022 salvato
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include "pitchdetector.h"
+
+#include <cmath>
+
+
+PitchDetector::PitchDetector(const std::vector<Note>& notes, int rate)
+    : sampleRate(rate)
+    , threshold(0.0)
+    , lastNote(-1)
+    , nAgreements(0)
+{
+    frequencies.reserve(notes.size());
+    for(const Note& note : notes)
+        frequencies.push_back(note.frequency);
+}
+
+
+PitchDetector::~PitchDetector() {
+}
+
+
+int
+PitchDetector::maxWindowSamples() const {
+    return windowSamples();
+}
+
+
+int
+PitchDetector::maxPolyphony() const {
+    return 1;
+}
+
+
+bool
+PitchDetector::acceptsInt16() const {
+    return false;
+}
+
+
+bool
+PitchDetector::processInt16(const int16_t* x, int nSamples, int nNewSamples, PitchEstimate* pEstimate) {
+    (void)x;
+    (void)nSamples;
+    (void)nNewSamples;
+    (void)pEstimate;
+    return false;
+}
+
+
+void
+PitchDetector::setTargetNote(int note) {
+    (void)note;
+}
+
+
+void
+PitchDetector::setCandidates(int firstNote, int lastNote) {
+    (void)firstNote;
+    (void)lastNote;
+}
+
+
+void
+PitchDetector::reset() {
+    lastNote    = -1;
+    nAgreements = 0;
+}
+
+
+void
+PitchDetector::setThreshold(double meanSquare) {
+    threshold = meanSquare;
+}
+
+
+// Index of the note closest (in cents) to the given frequency
+int
+PitchDetector::noteFromFrequency(double frequency) const {
+    if(frequency <= 0.0 || frequencies.empty())
+        return -1;
+    int nNotes = int(frequencies.size());
+    int note = int(std::floor(12.0*std::log2(frequency/frequencies[0])+0.5));
+    if(note < 0) note = 0;
+    if(note > nNotes-1) note = nNotes-1;
+    // The table is not exactly equally tempered: check the neighbours too
+    double best = std::fabs(std::log2(frequency/frequencies[note]));
+    for(int i=(note > 0 ? note-1 : 0); i<=note+1 && i<nNotes; i++) {
+        double distance = std::fabs(std::log2(frequency/frequencies[i]));
+        if(distance < best) {
+            best = distance;
+            note = i;
+        }
+    }
+    return note;
+}
+
+
+// To avoid false detections the same note must be found
+// in two consecutive blocks (as done by the original detector)
+bool
+PitchDetector::isStable(int note) {
+    if(note == lastNote)
+        nAgreements++;
+    else
+        nAgreements = 0;
+    lastNote = note;
+    return nAgreements > 0;
+}
+
+
+// Position of the vertex of the parabola passing through
+// (-1, left), (0, center), (1, right), relative to center
+double
+PitchDetector::parabolicOffset(double left, double center, double right) {
+    double denominator = left-2.0*center+right;
+    if(std::fabs(denominator) < 1.0e-12)
+        return 0.0;
+    double offset = 0.5*(left-right)/denominator;
+    if(offset < -1.0) offset = -1.0;
+    if(offset >  1.0) offset =  1.0;
+    return offset;
+}
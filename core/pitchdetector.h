@@ -0,0 +1,86 @@
+/*
+MIT License
+
+Copyright (c) 2022 salvato
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#pragma once
+
+#include "note.h"
+#include <cstdint>
+#include <vector>
+
+
+// What a detector has found in a block of samples
+struct PitchEstimate {
+    static const int maxNotes = 3;
+    int note;          // Index in the notes table
+    double frequency;  // Estimated fundamental frequency (Hz)
+    double confidence; // From 0 (noise) to 1 (pure tone)
+    double energy;     // Mean square value of the analysed samples
+    int nNotes;           // Simultaneous notes found (dyads and triads)
+    int notes[maxNotes];  // Their indexes, lowest first (notes[0] == note)
+    int64_t captureTime;  // When the newest samples were received
+    int64_t publishTime;  // When the worker published the estimate
+};
+
+
+// Block in, note/confidence out.
+// Every detector preallocates its buffers and reuses them between blocks.
+class PitchDetector
+{
+public:
+    PitchDetector(const std::vector<Note>& notes, int sampleRate);
+    virtual ~PitchDetector();
+    virtual const char* name() const = 0;
+    // Number of samples process() wants in every block
+    virtual int windowSamples() const = 0;
+    // Largest windowSamples() the detector can ask for
+    virtual int maxWindowSamples() const;
+    // Most simultaneous notes the detector can report (1 for most of them)
+    virtual int maxPolyphony() const;
+    // The note the player has been asked for (ignored by most detectors)
+    virtual void setTargetNote(int note);
+    // Notes playable on the selected string: [firstNote, lastNote)
+    virtual void setCandidates(int firstNote, int lastNote);
+    // Returns true when a note has been detected in x[0..nSamples-1].
+    // The last nNewSamples samples were not in the previous block.
+    virtual bool process(const float* x, int nSamples, int nNewSamples, PitchEstimate* pEstimate) = 0;
+    // Detectors with a fixed point path get the int16 samples directly
+    // (in [-SHRT_MAX, SHRT_MAX]) instead of their float conversion
+    virtual bool acceptsInt16() const;
+    virtual bool processInt16(const int16_t* x, int nSamples, int nNewSamples, PitchEstimate* pEstimate);
+    virtual void reset();
+    // Blocks whose mean square value is below the threshold are not analysed
+    void setThreshold(double meanSquare);
+    int noteFromFrequency(double frequency) const;
+
+protected:
+    bool isStable(int note);
+    static double parabolicOffset(double left, double center, double right);
+
+protected:
+    std::vector<double> frequencies;
+    int sampleRate;
+    double threshold;
+    int lastNote;
+    int nAgreements;
+};
@@ -0,0 +1,257 @@
+/*
+MIT License
+
+Copyright (c) 2022 salvato
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include "polyphonicdetector.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+
+
+// The largest power of 2 not longer than 0.2s:
+// 8192 samples (170ms) at 48kHz, 2048 at 12kHz
+static int
+windowLength(int sampleRate) {
+    int n = 1024;
+    while(2*n <= sampleRate/5)
+        n *= 2;
+    return n;
+}
+
+
+PolyphonicDetector::PolyphonicDetector(const std::vector<Note>& notes, int sampleRate)
+    : PitchDetector(notes, sampleRate)
+    , nWindow(windowLength(sampleRate))
+    , nFft(2*nWindow)
+    , nBins(0)
+    , first(0)
+    , nCandidates(0)
+    , nHarmonics(maxHarmonics)
+    , blockLoad(0.0)
+    , fft(nFft)
+    , window(nWindow)
+    , padded(nFft, 0.0f)
+    , spectrum(nFft/2+1)
+    , magnitude(nFft/2+1, 0.0f)
+    , residual(nFft/2+1, 0.0f)
+    , bandLow(maxCandidates*maxHarmonics, 0)
+    , bandHigh(maxCandidates*maxHarmonics, 0)
+    , weight(maxCandidates*maxHarmonics, 0.0f)
+{
+    const double pi = 3.14159265358979323846;
+    for(int t=0; t<nWindow; t++)
+        window[t] = float(0.5-0.5*std::cos(2.0*pi*(t+0.5)/nWindow));
+    // The main lobe of the (zero padded) window is the
+    // shape of every partial in the magnitude spectrum
+    std::copy(window.begin(), window.end(), padded.begin());
+    fft.forward(padded.data(), spectrum.data());
+    for(int k=0; k<=lobe; k++)
+        kernel[k] = std::abs(spectrum[k])/std::abs(spectrum[0]);
+}
+
+
+const char*
+PolyphonicDetector::name() const {
+    return "Polyphonic (chords)";
+}
+
+
+int
+PolyphonicDetector::windowSamples() const {
+    return nWindow;
+}
+
+
+int
+PolyphonicDetector::maxPolyphony() const {
+    return PitchEstimate::maxNotes;
+}
+
+
+double
+PolyphonicDetector::load() const {
+    return blockLoad;
+}
+
+
+void
+PolyphonicDetector::setCandidates(int firstNote, int lastNote) {
+    firstNote = std::max(0, firstNote);
+    lastNote  = std::min(int(frequencies.size()), lastNote);
+    int nNew  = std::max(0, std::min(maxCandidates, lastNote-firstNote));
+    if(firstNote == first && nNew == nCandidates)
+        return;
+    first = firstNote;
+    nCandidates = nNew;
+    buildBands();
+    PitchDetector::reset();
+}
+
+
+// Every harmonic is searched within a quarter of tone of its nominal
+// frequency. The weights (Klapuri, 2006) favour the lower harmonics.
+void
+PolyphonicDetector::buildBands() {
+    const double binsPerHz = double(nFft)/sampleRate;
+    const double tolerance = std::pow(2.0, 1.0/24.0)-1.0;
+    const int lastBin = nFft/2-lobe;
+    nBins = 0;
+    for(int c=0; c<nCandidates; c++) {
+        double f0 = frequencies[first+c];
+        for(int h=0; h<maxHarmonics; h++) {
+            int i = c*maxHarmonics+h;
+            double center = (h+1)*f0*binsPerHz;
+            double half   = std::max(1.0, center*tolerance);
+            bandLow[i]  = std::min(lastBin, int(std::floor(center-half)));
+            bandHigh[i] = std::min(lastBin, int(std::ceil(center+half)));
+            weight[i]   = float((f0+52.0)/((h+1)*f0+320.0));
+            if(bandLow[i] == lastBin) // Above the Nyquist frequency
+                weight[i] = 0.0f;
+            nBins = std::max(nBins, bandHigh[i]+lobe+1);
+        }
+    }
+}
+
+
+double
+PolyphonicDetector::salience(int candidate) const {
+    const int* pLow  = bandLow.data()+candidate*maxHarmonics;
+    const int* pHigh = bandHigh.data()+candidate*maxHarmonics;
+    const float* pWeight = weight.data()+candidate*maxHarmonics;
+    double sum = 0.0;
+    for(int h=0; h<nHarmonics; h++) {
+        float peak = *std::max_element(residual.data()+pLow[h], residual.data()+pHigh[h]+1);
+        sum += pWeight[h]*peak;
+    }
+    return sum;
+}
+
+
+// The partials of the detected note are removed from the residual.
+// Every amplitude is limited by the mean of its neighbours (the spectral
+// envelope of a string is smooth), so a partial shared with another
+// note that is still to be found is only partially cancelled.
+void
+PolyphonicDetector::cancel(int candidate) {
+    const int* pLow  = bandLow.data()+candidate*maxHarmonics;
+    const int* pHigh = bandHigh.data()+candidate*maxHarmonics;
+    int peakBin[maxHarmonics];
+    float amplitude[maxHarmonics];
+    for(int h=0; h<nHarmonics; h++) {
+        const float* pPeak = std::max_element(residual.data()+pLow[h], residual.data()+pHigh[h]+1);
+        peakBin[h]   = int(pPeak-residual.data());
+        amplitude[h] = *pPeak;
+    }
+    for(int h=0; h<nHarmonics; h++) {
+        float sum = amplitude[h];
+        int n = 1;
+        if(h > 0)            { sum += amplitude[h-1]; n++; }
+        if(h < nHarmonics-1) { sum += amplitude[h+1]; n++; }
+        float smooth = std::min(amplitude[h], sum/n);
+        int k0 = std::max(0, peakBin[h]-lobe);
+        for(int k=k0; k<=peakBin[h]+lobe; k++)
+            residual[k] = std::max(0.0f, residual[k]-smooth*kernel[std::abs(k-peakBin[h])]);
+    }
+}
+
+
+bool
+PolyphonicDetector::process(const float* x, int nSamples, int nNewSamples, PitchEstimate* pEstimate) {
+    if(nCandidates == 0 || nSamples < nWindow)
+        return false;
+    auto startTime = std::chrono::steady_clock::now();
+    x += nSamples-nWindow;
+    double energy = 0.0;
+    for(int t=0; t<nWindow; t++) {
+        energy += double(x[t])*x[t];
+        padded[t] = x[t]*window[t];
+    }
+    energy /= nWindow;
+    if(energy < threshold) {
+        PitchDetector::reset();
+        return false;
+    }
+    fft.forward(padded.data(), spectrum.data());
+    for(int k=0; k<nBins; k++)
+        magnitude[k] = std::abs(spectrum[k]);
+    std::copy(magnitude.begin(), magnitude.begin()+nBins, residual.begin());
+
+    // Iterative estimation and cancellation. A new note is accepted while
+    // the sum of the saliences divided by nNotes^0.4 keeps growing.
+    int chord[PitchEstimate::maxNotes];
+    int nNotes = 0;
+    double total = 0.0;
+    double lastScore = 0.0;
+    double firstSalience = 0.0;
+    while(nNotes < PitchEstimate::maxNotes) {
+        int best = -1;
+        double bestSalience = 0.0;
+        for(int c=0; c<nCandidates; c++) {
+            double s = salience(c);
+            if(s > bestSalience) {
+                bestSalience = s;
+                best = c;
+            }
+        }
+        if(best < 0)
+            break;
+        double score = (total+bestSalience)/std::pow(double(nNotes+1), 0.4);
+        if(nNotes > 0 && score <= lastScore)
+            break;
+        if(nNotes == 0)
+            firstSalience = bestSalience;
+        total += bestSalience;
+        lastScore = score;
+        chord[nNotes++] = first+best;
+        cancel(best);
+    }
+
+    // The compute time is measured against the block duration: if the
+    // detector takes more than half of it, fewer harmonics are summed
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now()-startTime).count();
+    if(nNewSamples > 0) {
+        blockLoad = 0.9*blockLoad+0.1*seconds*sampleRate/nNewSamples;
+        if(blockLoad > 0.5 && nHarmonics > minHarmonics)
+            nHarmonics--;
+        else if(blockLoad < 0.2 && nHarmonics < maxHarmonics)
+            nHarmonics++;
+    }
+
+    if(nNotes == 0)
+        return false;
+    std::sort(chord, chord+nNotes);
+    int key = 0; // The whole chord must be stable, not just its lowest note
+    for(int i=0; i<nNotes; i++)
+        key = key*256+chord[i]+1;
+    if(!isStable(key))
+        return false;
+    pEstimate->note       = chord[0];
+    pEstimate->frequency  = frequencies[chord[0]];
+    pEstimate->confidence = firstSalience > 0.0 ? std::min(1.0, total/(nNotes*firstSalience)) : 0.0;
+    pEstimate->energy     = energy;
+    pEstimate->nNotes     = nNotes;
+    for(int i=0; i<nNotes; i++)
+        pEstimate->notes[i] = chord[i];
+    return true;
+}
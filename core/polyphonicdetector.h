@@ -0,0 +1,79 @@
+/*
+MIT License
+
+Copyright (c) 2022 salvato
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#pragma once
+
+#include "pitchdetector.h"
+#include "fft.h"
+#include <complex>
+
+
+// Multi pitch detector for double stops and chords.
+// The salience of every candidate note is the weighted sum of the
+// magnitude spectrum at its harmonics. The best candidate is taken and
+// its harmonics are cancelled from the residual spectrum, then the
+// search is repeated while the polyphony estimate keeps growing.
+// The compute time of every block is measured against the block
+// duration and the number of harmonics is adapted to stay in budget.
+class PolyphonicDetector : public PitchDetector
+{
+public:
+    PolyphonicDetector(const std::vector<Note>& notes, int sampleRate);
+    const char* name() const override;
+    int windowSamples() const override;
+    int maxPolyphony() const override;
+    void setCandidates(int firstNote, int lastNote) override;
+    bool process(const float* x, int nSamples, int nNewSamples, PitchEstimate* pEstimate) override;
+    // Smoothed ratio between compute time and block duration
+    double load() const;
+
+protected:
+    void buildBands();
+    double salience(int candidate) const;
+    void cancel(int candidate);
+
+private:
+    static constexpr int maxCandidates = 24;
+    static constexpr int minHarmonics  = 4;
+    static constexpr int maxHarmonics  = 10;
+    static constexpr int lobe = 4; // Half width (in bins) of the Hann main lobe
+    int nWindow;
+    int nFft;     // Twice the window: zero padded
+    int nBins;    // Bins actually needed by the candidates
+    int first;
+    int nCandidates;
+    int nHarmonics;
+    double blockLoad;
+    RealFft fft;
+    std::vector<float> window;
+    std::vector<float> padded;
+    std::vector<std::complex<float>> spectrum;
+    std::vector<float> magnitude;
+    std::vector<float> residual;
+    float kernel[lobe+1]; // Main lobe of the window, normalized
+    // One band (and one weight) for every (candidate, harmonic) pair
+    std::vector<int> bandLow;
+    std::vector<int> bandHigh;
+    std::vector<float> weight;
+};
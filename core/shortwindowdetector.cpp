@@ -0,0 +1,58 @@
+/*
+MIT License
+
+Copyright (c) 2022 salvato
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include "shortwindowdetector.h"
+
+#include <cmath>
+
+
+// minFrequency and maxFrequency bound the notes that can be targets
+ShortWindowDetector::ShortWindowDetector(const std::vector<Note>& notes, int sampleRate,
+                                         double minFrequency, double maxFrequency,
+                                         int periods)
+    : MpmDetector(notes, sampleRate, 0.5*minFrequency/1.06, 2.0*maxFrequency*1.06)
+    , nPeriods(periods)
+    , targetNote(-1)
+{
+    windowCapacity = int(std::ceil(nPeriods*sampleRate/minFrequency));
+}
+
+
+const char*
+ShortWindowDetector::name() const {
+    return "Low latency";
+}
+
+
+void
+ShortWindowDetector::setTargetNote(int note) {
+    if(note == targetNote || note < 0 || note >= int(frequencies.size()))
+        return;
+    targetNote = note;
+    double period = double(sampleRate)/frequencies[targetNote];
+    configure(int(std::floor(0.5*period/1.06)),
+              int(std::ceil(2.0*period*1.06)),
+              int(std::ceil(nPeriods*period)));
+    PitchDetector::reset();
+}
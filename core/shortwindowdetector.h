@@ -0,0 +1,46 @@
+/*
+MIT License
+
+Copyright (c) 2022 salvato
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#pragma once
+
+#include "mpmdetector.h"
+
+
+// Low latency mode: the window only holds a few periods of the note the
+// player has been asked for, and only the lags from one octave above to
+// one octave below that note are searched. The sub-sample (parabolic)
+// interpolation of the NSDF peak keeps the accuracy of longer windows.
+class ShortWindowDetector : public MpmDetector
+{
+public:
+    ShortWindowDetector(const std::vector<Note>& notes, int sampleRate,
+                        double minFrequency, double maxFrequency,
+                        int periods);
+    const char* name() const override;
+    void setTargetNote(int note) override;
+
+private:
+    int nPeriods;
+    int targetNote;
+};
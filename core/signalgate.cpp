@@ -0,0 +1,219 @@
+/*
+MIT License
+
+Copyright (c) 2022 salvato
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include "signalgate.h"
+
+#include <algorithm>
+#include <climits>
+#include <cmath>
+
+
+namespace {
+// Noise floor: the 10th percentile of the frame levels, tracked with
+// steps of half a dB. It falls at 45dB/s and rises at 5dB/s; in the
+// first 2s of a note only at 1.5dB/s, so that the ringing string does
+// not become the floor.
+const double floorPercentile = 0.1;
+const double floorStep       = 0.5;
+const double noteStepScale   = 0.3;
+const int noteFrames         = 200;
+const double lowestFloorDb   = -120.0;
+} // namespace
+
+
+// Frames of 10ms; the gate stays open for 100ms after the signal
+// has gone below half of the threshold.
+SignalGate::SignalGate(int sampleRate)
+    : frameSize(sampleRate/100)
+    , holdFrames(10)
+    , threshold(1.0e-4)
+    , minimumThreshold(1.0e-4)
+    , noiseOffset(-1.0)
+    , floorDb(0.0)
+    , bFloorKnown(false)
+    , fluxThreshold(2.0)
+{
+    const double pi = 3.14159265358979323846;
+    const double cutoff[nBands-1] = {200.0, 500.0, 1200.0, 3000.0};
+    for(int b=0; b<nBands-1; b++)
+        alpha[b] = float(1.0-std::exp(-2.0*pi*cutoff[b]/sampleRate));
+    reset();
+}
+
+
+void
+SignalGate::reset() {
+    for(int b=0; b<nBands-1; b++)
+        lowPass[b] = 0.0f;
+    for(int b=0; b<nBands; b++) {
+        bandEnergy[b]    = 0.0;
+        lastLogEnergy[b] = 0.0;
+    }
+    frameEnergy  = 0.0;
+    nInFrame     = 0;
+    nQuietFrames = 0;
+    nSinceOnset  = noteFrames;
+    lastLevel    = 0.0;
+    bOpen        = false;
+    bOnset       = false;
+}
+
+
+// The noise floor survives reset(): it belongs to the device
+void
+SignalGate::setThreshold(double meanSquare) {
+    minimumThreshold = meanSquare;
+    updateThreshold();
+}
+
+
+void
+SignalGate::setNoiseOffset(double dB) {
+    noiseOffset = dB;
+    updateThreshold();
+}
+
+
+// A floor saved for the device, refined by the next frames
+void
+SignalGate::setNoiseFloor(double meanSquare) {
+    bFloorKnown = meanSquare > 0.0;
+    if(bFloorKnown)
+        floorDb = std::max(lowestFloorDb, 10.0*std::log10(meanSquare));
+    updateThreshold();
+}
+
+
+double
+SignalGate::noiseFloor() const {
+    return bFloorKnown ? std::pow(10.0, floorDb/10.0) : 0.0;
+}
+
+
+double
+SignalGate::currentThreshold() const {
+    return threshold;
+}
+
+
+void
+SignalGate::trackNoiseFloor() {
+    double dB = std::max(lowestFloorDb, 10.0*std::log10(lastLevel+1.0e-12));
+    if(!bFloorKnown) {
+        floorDb = dB;
+        bFloorKnown = true;
+    }
+    else if(dB < floorDb) {
+        floorDb -= floorStep*(1.0-floorPercentile);
+    }
+    else {
+        bool bRinging = bOpen && nSinceOnset < noteFrames;
+        floorDb += floorStep*floorPercentile*(bRinging ? noteStepScale : 1.0);
+    }
+    updateThreshold();
+}
+
+
+void
+SignalGate::updateThreshold() {
+    threshold = minimumThreshold;
+    if(noiseOffset >= 0.0 && bFloorKnown)
+        threshold = std::max(minimumThreshold, std::pow(10.0, (floorDb+noiseOffset)/10.0));
+}
+
+
+bool
+SignalGate::isOpen() const {
+    return bOpen;
+}
+
+
+bool
+SignalGate::takeOnset() {
+    bool bResult = bOnset;
+    bOnset = false;
+    return bResult;
+}
+
+
+double
+SignalGate::level() const {
+    return lastLevel;
+}
+
+
+bool
+SignalGate::push(const int16_t* pIn, int nSamples) {
+    const float scale = 1.0f/float(SHRT_MAX);
+    for(int i=0; i<nSamples; i++) {
+        float x = float(pIn[i])*scale;
+        float previous = 0.0f;
+        for(int b=0; b<nBands-1; b++) {
+            lowPass[b] += alpha[b]*(x-lowPass[b]);
+            float band = lowPass[b]-previous;
+            bandEnergy[b] += double(band)*band;
+            previous = lowPass[b];
+        }
+        float high = x-previous;
+        bandEnergy[nBands-1] += double(high)*high;
+        frameEnergy += double(x)*x;
+        if(++nInFrame < frameSize)
+            continue;
+
+        // End of frame: level, onset function and gate state
+        lastLevel = frameEnergy/frameSize;
+        nSinceOnset++;
+        trackNoiseFloor();
+        // The flux is measured against a band envelope with instant
+        // attack and slow release, so that the beats of the low partials
+        // and the rise of a note already found do not look like onsets
+        double flux = 0.0;
+        for(int b=0; b<nBands; b++) {
+            double logEnergy = std::log(bandEnergy[b]/frameSize+1.0e-10);
+            if(logEnergy > lastLogEnergy[b]) {
+                flux += logEnergy-lastLogEnergy[b];
+                lastLogEnergy[b] = logEnergy;
+            }
+            else {
+                lastLogEnergy[b] = 0.9*lastLogEnergy[b]+0.1*logEnergy;
+            }
+            bandEnergy[b] = 0.0;
+        }
+        if(lastLevel >= threshold) {
+            if(flux > fluxThreshold) {
+                bOnset = true;
+                nSinceOnset = 0;
+            }
+            bOpen = true;
+            nQuietFrames = 0;
+        }
+        else if(lastLevel < 0.5*threshold && bOpen) {
+            if(++nQuietFrames > holdFrames)
+                bOpen = false;
+        }
+        frameEnergy = 0.0;
+        nInFrame = 0;
+    }
+    return bOpen;
+}
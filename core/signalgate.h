@@ -0,0 +1,78 @@
+/*
+MIT License
+
+Copyright (c) 2022 salvato
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#pragma once
+
+#include <cstdint>
+
+
+// Cheap streaming gate in front of the pitch detectors.
+// In a single pass over the new samples it computes the signal power
+// and a spectral flux onset function (on five bands split by one pole
+// low pass filters). The expensive detectors only run while it is open.
+// The threshold follows the noise floor of the input (a running low
+// percentile of the frame levels) plus an offset, never going below a
+// fixed minimum.
+class SignalGate
+{
+public:
+    explicit SignalGate(int sampleRate);
+    void reset();
+    void setThreshold(double meanSquare); // The minimum threshold
+    void setNoiseOffset(double dB);       // Negative: fixed threshold
+    void setNoiseFloor(double meanSquare);
+    // Processes new samples and returns true while the gate is open
+    bool push(const int16_t* pIn, int nSamples);
+    bool isOpen() const;
+    bool takeOnset();   // True once after every onset
+    double level() const; // Mean square value of the last frame
+    double noiseFloor() const; // Mean square value, 0 until known
+    double currentThreshold() const;
+
+protected:
+    void trackNoiseFloor();
+    void updateThreshold();
+
+private:
+    static const int nBands = 5;
+    int frameSize;
+    int holdFrames;
+    double threshold;
+    double minimumThreshold;
+    double noiseOffset;
+    double floorDb;
+    bool bFloorKnown;
+    double fluxThreshold;
+    float alpha[nBands-1]; // One pole low pass coefficients
+    float lowPass[nBands-1];
+    double bandEnergy[nBands];
+    double lastLogEnergy[nBands]; // Log band envelopes
+    double frameEnergy;
+    int nInFrame;
+    int nQuietFrames;
+    int nSinceOnset;
+    double lastLevel;
+    bool bOpen;
+    bool bOnset;
+};
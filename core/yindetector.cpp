@@ -0,0 +1,112 @@
+/*
+MIT License
+
+Copyright (c) 2022 salvato
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include "yindetector.h"
+#include "acfkernel.h"
+
+#include <algorithm>
+#include <cmath>
+
+
+YinDetector::YinDetector(const std::vector<Note>& notes, int sampleRate,
+                         double minFrequency, double maxFrequency)
+    : PitchDetector(notes, sampleRate)
+    , yinThreshold(0.15)
+{
+    tauMin = std::max(2, int(std::floor(sampleRate/maxFrequency)));
+    tauMax = int(std::ceil(sampleRate/minFrequency))+1;
+    W      = tauMax;
+    lags.resize(tauMax+1);
+    for(int tau=0; tau<=tauMax; tau++)
+        lags[tau] = tau;
+    r.assign(tauMax+1, 0.0);
+    cmnd.assign(tauMax+1, 1.0);
+}
+
+
+const char*
+YinDetector::name() const {
+    return "YIN";
+}
+
+
+int
+YinDetector::windowSamples() const {
+    return W+tauMax;
+}
+
+
+bool
+YinDetector::process(const float* x, int nSamples, int nNewSamples, PitchEstimate* pEstimate) {
+    (void)nNewSamples;
+    if(nSamples < windowSamples())
+        return false;
+    // The difference function d(tau) = e(0) + e(tau) - 2r(tau)
+    // is obtained from the autocorrelation (vector kernel)
+    std::fill(r.begin(), r.end(), 0.0);
+    acfAccumulate(x, W, lags.data(), tauMax+1, r.data());
+    const double e0 = r[0];
+    if(e0/W < threshold) {
+        PitchDetector::reset();
+        return false;
+    }
+    double eTau = e0;
+    double runningSum = 0.0;
+    cmnd[0] = 1.0;
+    for(int tau=1; tau<=tauMax; tau++) {
+        eTau += double(x[tau+W-1])*x[tau+W-1]-double(x[tau-1])*x[tau-1];
+        double d = std::max(0.0, e0+eTau-2.0*r[tau]);
+        runningSum += d;
+        cmnd[tau] = runningSum > 0.0 ? d*tau/runningSum : 1.0;
+    }
+    // The first dip below the absolute threshold, or the global minimum
+    int best = -1;
+    for(int tau=tauMin; tau<tauMax; tau++) {
+        if(cmnd[tau] < yinThreshold) {
+            while(tau+1 < tauMax && cmnd[tau+1] < cmnd[tau])
+                tau++;
+            best = tau;
+            break;
+        }
+    }
+    if(best < 0) {
+        best = tauMin;
+        for(int tau=tauMin+1; tau<tauMax; tau++)
+            if(cmnd[tau] < cmnd[best]) best = tau;
+        if(cmnd[best] > 0.5) { // Unvoiced
+            PitchDetector::reset();
+            return false;
+        }
+    }
+    double period = best+parabolicOffset(cmnd[best-1], cmnd[best], cmnd[best+1]);
+    double frequency = double(sampleRate)/period;
+    int note = noteFromFrequency(frequency);
+    if(!isStable(note))
+        return false;
+    pEstimate->note       = note;
+    pEstimate->frequency  = frequency;
+    pEstimate->confidence = std::max(0.0, 1.0-cmnd[best]);
+    pEstimate->energy     = e0/W;
+    return true;
+}
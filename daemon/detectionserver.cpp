@@ -0,0 +1,96 @@
+/*
+MIT License
+
+Copyright (c) 2022 salvato
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include "detectionserver.h"
+#include "streamsession.h"
+
+#include <QLocalServer>
+#include <QLocalSocket>
+#include <QDebug>
+
+
+DetectionServer::DetectionServer(int nThreads, int maxStreams, QObject* parent)
+    : QObject(parent)
+    , notes(equalTemperament())
+    , pServer(new QLocalServer(this))
+    , maxSessions(maxStreams)
+    , nSessions(0)
+{
+    pool.setMaxThreadCount(nThreads > 0 ? nThreads : QThread::idealThreadCount());
+    pool.setThreadPriority(QThread::TimeCriticalPriority);
+    pServer->setSocketOptions(QLocalServer::UserAccessOption);
+    connect(pServer, SIGNAL(newConnection()),
+            this, SLOT(onNewConnection()));
+}
+
+
+// The sessions (children) are deleted after this: none is on the pool anymore
+DetectionServer::~DetectionServer() {
+    pServer->close();
+    pool.waitForDone();
+}
+
+
+// A socket left by a crashed daemon is removed
+bool
+DetectionServer::listen(const QString& sSocketName) {
+    QLocalServer::removeServer(sSocketName);
+    if(!pServer->listen(sSocketName))
+        return false;
+    qInfo() << "Listening on" << pServer->fullServerName()
+            << "with" << pool.maxThreadCount() << "detection threads";
+    return true;
+}
+
+
+QString
+DetectionServer::errorString() const {
+    return pServer->errorString();
+}
+
+
+void
+DetectionServer::onNewConnection() {
+    while(pServer->hasPendingConnections()) {
+        QLocalSocket* pSocket = pServer->nextPendingConnection();
+        if(maxSessions > 0 && nSessions >= maxSessions) {
+            connect(pSocket, SIGNAL(disconnected()),
+                    pSocket, SLOT(deleteLater()));
+            pSocket->write("error too many streams\n");
+            pSocket->disconnectFromServer();
+            continue;
+        }
+        StreamSession* pSession = new StreamSession(pSocket, notes, &pool, this);
+        connect(pSession, SIGNAL(finished()),
+                this, SLOT(onSessionFinished()));
+        nSessions++;
+    }
+}
+
+
+void
+DetectionServer::onSessionFinished() {
+    sender()->deleteLater();
+    nSessions--;
+}
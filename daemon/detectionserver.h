@@ -22,18 +22,37 @@ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
 SOFTWARE.
 */
 
+#pragma once
+
 #include "note.h"
+#include <QObject>
+#include <QThreadPool>
+#include <vector>
 
 
-Note::Note()
-    : sname(QString())
-    , frequency(0.0)
-{
-}
+class QLocalServer;
+class StreamSession;
 
 
-Note::Note(QString name, double f)
-    : sname(name)
-    , frequency(f)
+// Accepts the client streams on a local (Unix domain) socket. The
+// detectors of all the streams share a fixed thread pool.
+class DetectionServer : public QObject
 {
-}
+    Q_OBJECT
+public:
+    DetectionServer(int nThreads, int maxStreams, QObject* parent = nullptr);
+    ~DetectionServer();
+    bool listen(const QString& sSocketName);
+    QString errorString() const;
+
+private slots:
+    void onNewConnection();
+    void onSessionFinished();
+
+private:
+    std::vector<Note> notes;
+    QThreadPool pool;
+    QLocalServer* pServer;
+    int maxSessions;
+    int nSessions;
+};
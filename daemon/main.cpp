@@ -0,0 +1,63 @@
+/*
+MIT License
+
+Copyright (c) 2022 salvato
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+// Headless detection service: the detectors of the App behind a local
+// (Unix domain) socket, so that many clients (kiosks, a web front end)
+// share one process. See protocol.h for the stream format and the
+// streamclient folder for a client replaying WAV files.
+
+#include "detectionserver.h"
+#include "protocol.h"
+
+#include <QCoreApplication>
+#include <QCommandLineParser>
+#include <QTextStream>
+
+
+int
+main(int argc, char *argv[]) {
+    QCoreApplication::setOrganizationDomain("Gabriele.Salvato");
+    QCoreApplication::setOrganizationName("Gabriele.Salvato");
+    QCoreApplication::setApplicationName("NoteDaemon");
+    QCoreApplication::setApplicationVersion("0.0.1");
+    QCoreApplication app(argc, argv);
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Serves the NoteLearn pitch detectors on a local socket");
+    parser.addHelpOption();
+    parser.addVersionOption();
+    QCommandLineOption socketOption({"s", "socket"}, "Name (or path) of the local socket.", "name", Protocol::defaultSocketName);
+    QCommandLineOption threadsOption({"j", "threads"}, "Detection threads (0: one per core).", "n", "0");
+    QCommandLineOption streamsOption("max-streams", "Most concurrent streams (0: no limit).", "n", "64");
+    parser.addOptions({socketOption, threadsOption, streamsOption});
+    parser.process(app);
+
+    DetectionServer server(parser.value(threadsOption).toInt(),
+                           parser.value(streamsOption).toInt());
+    if(!server.listen(parser.value(socketOption))) {
+        QTextStream(stderr) << parser.value(socketOption) << ": " << server.errorString() << Qt::endl;
+        return EXIT_FAILURE;
+    }
+    return app.exec();
+}
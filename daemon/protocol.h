@@ -0,0 +1,53 @@
+/*
+MIT License
+
+Copyright (c) 2022 salvato
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#pragma once
+
+#include <cstdint>
+
+
+// The local socket protocol of NoteDaemon.
+//
+// The client opens the stream with one text line:
+//     NOTELEARN/1 rate=48000 detector=0 decimation=1 string=0 threshold=5 offset=-1\n
+// (every key is optional) and the daemon answers "ok <detector name>\n"
+// or "error <reason>\n" (closing the connection).
+// Then the client sends frames of mono int16 little endian samples, each
+// preceded by its size in bytes (uint32 little endian); a frame of size
+// zero ends the stream. For every detection the daemon sends:
+//     note <stream time (s)> <names joined by +> <frequency> <confidence>\n
+// and, at the end of the stream, "end <frames> <detections>\n".
+//
+// A frame is read only when the detector has processed the previous one,
+// so a fast client is slowed down by the socket instead of filling memory.
+namespace Protocol {
+
+const char* const magic = "NOTELEARN/1";
+const char* const defaultSocketName = "notelearn";
+
+// The largest frame (1s at 48kHz) and the longest header line
+constexpr uint32_t maxFrameBytes = 96000;
+constexpr int maxHeaderBytes = 256;
+
+} // namespace Protocol
@@ -0,0 +1,257 @@
+/*
+MIT License
+
+Copyright (c) 2022 salvato
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include "streamsession.h"
+#include "protocol.h"
+#include "iobuffer.h"
+#include "dspworker.h"
+
+#include <QLocalSocket>
+#include <QtEndian>
+
+
+StreamSession::StreamSession(QLocalSocket* pClientSocket,
+                             const std::vector<Note>& noteTable,
+                             QThreadPool* pThreadPool,
+                             QObject* parent)
+    : QObject(parent)
+    , pSocket(pClientSocket)
+    , notes(noteTable)
+    , pPool(pThreadPool)
+    , pBuffer(nullptr)
+    , pDspWorker(nullptr)
+    , frame(Protocol::maxFrameBytes)
+    , frameBytes(0)
+    , frameOffset(0)
+    , sliceBytes(0)
+    , sampleRate(48000)
+    , samplesWritten(0)
+    , nFrames(0)
+    , nDetections(0)
+    , bStreaming(false)
+    , bBusy(false)
+    , bClosed(false)
+{
+    pSocket->setParent(this);
+    // One frame (with its size) always fits: no more is buffered
+    pSocket->setReadBufferSize(qint64(Protocol::maxFrameBytes)+qint64(Protocol::maxHeaderBytes));
+    connect(pSocket, SIGNAL(readyRead()),
+            this, SLOT(onReadyRead()));
+    connect(pSocket, SIGNAL(disconnected()),
+            this, SLOT(onDisconnected()));
+}
+
+
+StreamSession::~StreamSession() {
+    delete pDspWorker;
+}
+
+
+// "NOTELEARN/1 key=value ..."
+bool
+StreamSession::parseHeader(const QByteArray& line) {
+    QList<QByteArray> fields = line.simplified().split(' ');
+    if(fields.isEmpty() || fields.first() != Protocol::magic) {
+        fail("not a NOTELEARN/1 stream");
+        return false;
+    }
+    int detector    = 0;
+    int decimation  = 1;
+    int firstNote   = NoteTable::stringStart[0];
+    double threshold   = 5.0;
+    double noiseOffset = -1.0;
+    for(int i=1; i<fields.count(); i++) {
+        QList<QByteArray> keyValue = fields.at(i).split('=');
+        if(keyValue.count() != 2) {
+            fail(QString("bad field %1").arg(QString::fromLatin1(fields.at(i))));
+            return false;
+        }
+        const QByteArray& key = keyValue.at(0);
+        bool bOk = true;
+        if(key == "rate")
+            sampleRate = keyValue.at(1).toInt(&bOk);
+        else if(key == "detector")
+            detector = keyValue.at(1).toInt(&bOk);
+        else if(key == "decimation")
+            decimation = keyValue.at(1).toInt(&bOk);
+        else if(key == "string")
+            firstNote = NoteTable::stringStart[qBound(0, keyValue.at(1).toInt(&bOk), NoteTable::nStrings-1)];
+        else if(key == "threshold")
+            threshold = keyValue.at(1).toDouble(&bOk);
+        else if(key == "offset")
+            noiseOffset = keyValue.at(1).toDouble(&bOk);
+        if(!bOk) {
+            fail(QString("bad value of %1").arg(QString::fromLatin1(key)));
+            return false;
+        }
+    }
+    if(sampleRate < 8000 || sampleRate > 192000) {
+        fail("unsupported sample rate");
+        return false;
+    }
+
+    // The same buffers used by MainWindow for a 0.3s (in bytes) chunk
+    int nData = DspWorker::defaultWindowSamples(sampleRate);
+    pBuffer = new IOBuffer(2*nData, this);
+    pDspWorker = new DspWorker(pBuffer, notes, sampleRate, nData);
+    pBuffer->reserve(pDspWorker->maxWindowSamples()+nData);
+    sliceBytes = nData*int(sizeof(int16_t));
+    pDspWorker->setThreadPool(pPool);
+    detector = qBound(0, detector, pDspWorker->detectorCount()-1);
+    pDspWorker->setDetector(detector);
+    pDspWorker->setDecimation(decimation);
+    pDspWorker->setThreshold(threshold);
+    pDspWorker->setNoiseOffset(noiseOffset);
+    pDspWorker->setCandidates(firstNote, firstNote+NoteTable::nFrets);
+    connect(pBuffer, SIGNAL(bufferFull()),
+            pDspWorker, SLOT(onBufferFull()),
+            Qt::DirectConnection);
+    connect(pDspWorker, SIGNAL(resultReady()),
+            this, SLOT(onDetectionReady()),
+            Qt::QueuedConnection);
+    connect(pDspWorker, SIGNAL(idle()),
+            this, SLOT(onWorkerIdle()),
+            Qt::QueuedConnection);
+    pBuffer->open(QIODevice::WriteOnly);
+    pDspWorker->setActive(true);
+    pSocket->write(QString("ok %1\n").arg(pDspWorker->detectorName(detector)).toUtf8());
+    return true;
+}
+
+
+void
+StreamSession::onReadyRead() {
+    if(bClosed)
+        return;
+    if(!bStreaming) {
+        if(!pSocket->canReadLine()) {
+            if(pSocket->bytesAvailable() > Protocol::maxHeaderBytes)
+                fail("header too long");
+            return;
+        }
+        if(!parseHeader(pSocket->readLine(Protocol::maxHeaderBytes+1)))
+            return;
+        bStreaming = true;
+    }
+    readFrame();
+}
+
+
+// Only one frame at a time goes to the detector, a slice at a time
+void
+StreamSession::readFrame() {
+    if(bBusy || bClosed)
+        return;
+    if(frameOffset < frameBytes) {
+        writeSlice();
+        return;
+    }
+    if(pSocket->bytesAvailable() < qint64(sizeof(quint32)))
+        return;
+    char size[sizeof(quint32)];
+    pSocket->peek(size, sizeof(size));
+    quint32 nBytes = qFromLittleEndian<quint32>(size);
+    if(nBytes > Protocol::maxFrameBytes || nBytes % sizeof(int16_t)) {
+        fail("bad frame size");
+        return;
+    }
+    if(pSocket->bytesAvailable() < qint64(sizeof(size))+qint64(nBytes))
+        return;
+    pSocket->read(size, sizeof(size));
+    if(nBytes == 0) {
+        finish();
+        return;
+    }
+    pSocket->read(frame.data(), nBytes);
+    frameBytes  = int(nBytes);
+    frameOffset = 0;
+    nFrames++;
+    writeSlice();
+}
+
+
+// A frame can be longer than the ring: it is written one hop at a
+// time, the next slice when the detector has processed the previous one
+void
+StreamSession::writeSlice() {
+    int nBytes = qMin(sliceBytes, frameBytes-frameOffset);
+    samplesWritten += nBytes/int(sizeof(int16_t));
+    bBusy = true;
+    pBuffer->write(frame.data()+frameOffset, nBytes);
+    frameOffset += nBytes;
+}
+
+
+void
+StreamSession::onWorkerIdle() {
+    bBusy = false;
+    if(bClosed)
+        emit finished();
+    else
+        readFrame();
+}
+
+
+// Every result belongs to the last slice written
+void
+StreamSession::onDetectionReady() {
+    PitchEstimate estimate;
+    if(!pDspWorker->takeResult(&estimate) || bClosed)
+        return;
+    nDetections++;
+    QString sNotes;
+    for(int i=0; i<estimate.nNotes; i++)
+        sNotes += (i > 0 ? "+" : "")+notes[estimate.notes[i]].name();
+    pSocket->write(QString("note %1 %2 %3 %4\n")
+                       .arg(double(samplesWritten)/sampleRate, 0, 'f', 3)
+                       .arg(sNotes)
+                       .arg(estimate.frequency, 0, 'f', 2)
+                       .arg(estimate.confidence, 0, 'f', 2)
+                       .toUtf8());
+}
+
+
+void
+StreamSession::fail(const QString& sReason) {
+    pSocket->write(QString("error %1\n").arg(sReason).toUtf8());
+    pSocket->disconnectFromServer();
+}
+
+
+void
+StreamSession::finish() {
+    pSocket->write(QString("end %1 %2\n").arg(nFrames).arg(nDetections).toUtf8());
+    pSocket->disconnectFromServer();
+}
+
+
+// The session is deleted only when its detector is no longer on the pool
+void
+StreamSession::onDisconnected() {
+    bClosed = true;
+    if(pDspWorker)
+        pDspWorker->setActive(false);
+    if(!bBusy)
+        emit finished();
+}
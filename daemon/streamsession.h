@@ -0,0 +1,84 @@
+/*
+MIT License
+
+Copyright (c) 2022 salvato
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#pragma once
+
+#include "note.h"
+#include <QObject>
+#include <vector>
+
+
+class IOBuffer;
+class DspWorker;
+class QLocalSocket;
+class QThreadPool;
+
+
+// One client stream of the daemon: its socket, capture buffer and
+// detector. The memory of a stream is bounded: the ring of the
+// detector, one frame and the socket read buffer.
+class StreamSession : public QObject
+{
+    Q_OBJECT
+public:
+    StreamSession(QLocalSocket* pClientSocket,
+                  const std::vector<Note>& noteTable,
+                  QThreadPool* pThreadPool,
+                  QObject* parent = nullptr);
+    ~StreamSession();
+
+signals:
+    void finished();
+
+private slots:
+    void onReadyRead();
+    void onWorkerIdle();
+    void onDetectionReady();
+    void onDisconnected();
+
+protected:
+    bool parseHeader(const QByteArray& line);
+    void readFrame();
+    void writeSlice();
+    void fail(const QString& sReason);
+    void finish();
+
+private:
+    QLocalSocket* pSocket;
+    const std::vector<Note>& notes;
+    QThreadPool* pPool;
+    IOBuffer* pBuffer;
+    DspWorker* pDspWorker;
+    std::vector<char> frame;
+    int frameBytes;
+    int frameOffset; // Bytes of the frame already written to the ring
+    int sliceBytes;  // One hop: the ring holds it past the longest window
+    int sampleRate;
+    qint64 samplesWritten;
+    int nFrames;
+    int nDetections;
+    bool bStreaming;
+    bool bBusy;      // The detector has not processed the last slice yet
+    bool bClosed;
+};
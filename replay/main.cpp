@@ -0,0 +1,279 @@
+/*
+MIT License
+
+Copyright (c) 2022 salvato
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+// Headless replay of WAV files through the same IOBuffer and DspWorker
+// used by the App: no sound card and no widgets are needed.
+//
+// The audio "device" writes blocks of samples into the IOBuffer and the
+// event loop runs the queued detection after every write, so a replay is
+// deterministic. With --realtime the writes are paced by the clock.
+//
+// With --synthetic no file is needed: every note of the table is
+// synthesized and the accuracy of the detectors is reported.
+
+#include "wavreader.h"
+#include "syntheticsuite.h"
+#include "iobuffer.h"
+#include "dspworker.h"
+#include "latencystats.h"
+#include "alloccheck.h"
+#include "acfkernel.h"
+#include "note.h"
+
+#include <QCoreApplication>
+#include <QCommandLineParser>
+#include <QElapsedTimer>
+#include <QTextStream>
+#include <QThread>
+
+#if defined(NOTELEARN_ALLOC_CHECK)
+#include <csignal>
+#include <sys/wait.h>
+#include <unistd.h>
+#endif
+
+
+// The allocation hook must catch the containers of Qt, that allocate
+// through malloc() from inside the Qt libraries: a child process
+// formats a QString in a NoAllocScope and has to abort.
+static bool
+allocationAborts() {
+#if defined(NOTELEARN_ALLOC_CHECK)
+    pid_t pid = fork();
+    if(pid < 0)
+        return false;
+    if(pid == 0) {
+        int score = 42;
+        NoAllocScope noAlloc;
+        QString sScore = QString("%1").arg(score);
+        _exit(sScore.isEmpty() ? 2 : 0);
+    }
+    int status = 0;
+    if(waitpid(pid, &status, 0) != pid)
+        return false;
+    return WIFSIGNALED(status) && WTERMSIG(status) == SIGABRT;
+#else
+    return false;
+#endif
+}
+
+
+int
+main(int argc, char *argv[]) {
+    QCoreApplication::setOrganizationDomain("Gabriele.Salvato");
+    QCoreApplication::setOrganizationName("Gabriele.Salvato");
+    QCoreApplication::setApplicationName("NoteReplay");
+    QCoreApplication::setApplicationVersion("0.0.1");
+    QCoreApplication app(argc, argv);
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Replays WAV files through the NoteLearn pitch detectors");
+    parser.addHelpOption();
+    parser.addVersionOption();
+    parser.addPositionalArgument("files", "WAV files to replay", "file.wav...");
+    QCommandLineOption detectorOption({"d", "detector"}, "Detector index (see --list), \"all\" with --synthetic.", "index", "0");
+    QCommandLineOption listOption("list", "List the detectors and exit.");
+    QCommandLineOption rateOption({"r", "decimation"}, "Decimation factor: 1, 2 or 4.", "factor", "1");
+    QCommandLineOption blockOption({"b", "block"}, "Duration of every write (ms).", "ms", "150");
+    QCommandLineOption stringOption({"s", "string"}, "Candidate string: 0 (low E) to 5 (high e).", "string", "0");
+    QCommandLineOption thresholdOption({"t", "threshold"}, "Fixed detection threshold (the minimum one with --noise-offset).", "value", "5");
+    QCommandLineOption noiseOffsetOption("noise-offset", "Follow the noise floor, opening the gate this far above it (the App uses 6 to 22).", "dB");
+    QCommandLineOption fastOption({"f", "fast"}, "Low latency mode, centered on the given note index.", "note");
+    QCommandLineOption realtimeOption("realtime", "Write the blocks in real time instead of as fast as possible.");
+    QCommandLineOption latencyOption("latency", "Print the latency histograms at the end.");
+    QCommandLineOption syntheticOption("synthetic", "Run the accuracy suite on synthetic plucked strings.");
+    QCommandLineOption sampleRateOption("sample-rate", "Sample rate of the synthetic signals.", "Hz", "48000");
+    QCommandLineOption variationsOption("variations", "Synthetic trials for every note.", "n", "4");
+    QCommandLineOption inharmonicityOption("inharmonicity", "String stiffness, from 0 to 0.5.", "value", "0.1");
+    QCommandLineOption detuneOption("detune", "Largest random detuning (cents).", "cents", "10");
+    QCommandLineOption noiseOption("noise", "RMS of the added white noise (full scale = 1).", "value", "0.005");
+    QCommandLineOption minAccuracyOption("min-accuracy", "Fail when the accuracy on the guitar range is lower (%).", "percent", "0");
+    QCommandLineOption verifyKernelsOption("verify-kernels", "Compare every autocorrelation kernel this CPU can run with the double precision loop and exit.");
+    QCommandLineOption allocCheckOption("alloc-check", "Verify that an allocation in the real time path aborts (needs a build with CONFIG+=alloc_check), then replay.");
+    parser.addOptions({detectorOption, listOption, rateOption, blockOption, stringOption,
+                       thresholdOption, noiseOffsetOption, fastOption, realtimeOption, latencyOption,
+                       syntheticOption, sampleRateOption, variationsOption, inharmonicityOption,
+                       detuneOption, noiseOption, minAccuracyOption, verifyKernelsOption,
+                       allocCheckOption});
+    parser.process(app);
+
+    QTextStream out(stdout);
+    QTextStream err(stderr);
+
+    if(parser.isSet(verifyKernelsOption)) {
+        int nFailed = 0;
+        for(int i=0; i<acfKernelCount(); i++) {
+            double error = acfKernelError(i);
+            bool bOk = error < acfKernelTolerance;
+            nFailed += bOk ? 0 : 1;
+            out << QString("%1  relative error %2  %3")
+                       .arg(QString::fromLatin1(acfKernelNameAt(i)), -14)
+                       .arg(error, 0, 'g', 3)
+                       .arg(bOk ? QString("ok") : QString("FAILED"))
+                << Qt::endl;
+        }
+        out << "# selected: " << acfKernelName() << ", " << acfInt16KernelName() << Qt::endl;
+        return nFailed > 0 ? EXIT_FAILURE : EXIT_SUCCESS;
+    }
+
+    if(parser.isSet(allocCheckOption)) {
+        if(!NoAllocScope::enabled) {
+            err << "NoteReplay was built without CONFIG+=alloc_check" << Qt::endl;
+            return EXIT_FAILURE;
+        }
+        if(!allocationAborts()) {
+            err << "alloc check: a QString allocated in a NoAllocScope did not abort" << Qt::endl;
+            return EXIT_FAILURE;
+        }
+        out << "# alloc check: a QString allocated in a NoAllocScope aborts" << Qt::endl;
+        if(parser.positionalArguments().isEmpty() && !parser.isSet(syntheticOption))
+            return EXIT_SUCCESS;
+    }
+    std::vector<Note> notes = equalTemperament();
+
+    if(parser.isSet(syntheticOption)) {
+        SuiteOptions options;
+        options.detector       = parser.value(detectorOption) == "all" ? -1
+                               : qBound(0, parser.value(detectorOption).toInt(), DspWorker::nDetectorKinds-1);
+        options.sampleRate     = parser.value(sampleRateOption).toInt();
+        options.variations     = qMax(1, parser.value(variationsOption).toInt());
+        options.inharmonicity  = parser.value(inharmonicityOption).toDouble();
+        options.maxDetuneCents = parser.value(detuneOption).toDouble();
+        options.noiseLevel     = parser.value(noiseOption).toDouble();
+        options.threshold      = parser.value(thresholdOption).toDouble();
+        SuiteResult result = runSyntheticSuite(notes, options, out);
+        if(result.nMismatches > 0)
+            return EXIT_FAILURE;
+        return result.worstAccuracy < parser.value(minAccuracyOption).toDouble() ? EXIT_FAILURE : EXIT_SUCCESS;
+    }
+
+    const QStringList files = parser.positionalArguments();
+    if(files.isEmpty() && !parser.isSet(listOption)) {
+        parser.showHelp(EXIT_FAILURE);
+    }
+
+    int exitCode = EXIT_SUCCESS;
+    for(int iFile=0; iFile<qMax(1, int(files.count())); iFile++) {
+        WavReader wav;
+        int sampleRate = 48000;
+        if(!files.isEmpty()) {
+            if(!wav.load(files.at(iFile))) {
+                err << files.at(iFile) << ": " << wav.errorString() << Qt::endl;
+                exitCode = EXIT_FAILURE;
+                continue;
+            }
+            sampleRate = wav.sampleRate();
+        }
+
+        // The same buffers used by MainWindow for a 0.3s (in bytes) chunk
+        int nData = DspWorker::defaultWindowSamples(sampleRate);
+        IOBuffer buffer(2*nData);
+        DspWorker worker(&buffer, notes, sampleRate, nData);
+        LatencyStats latencyStats;
+        buffer.setLatencyStats(&latencyStats);
+        worker.setLatencyStats(&latencyStats);
+
+        if(parser.isSet(listOption)) {
+            for(int i=0; i<worker.detectorCount(); i++)
+                out << i << ": " << worker.detectorName(i) << Qt::endl;
+            out << "# autocorrelation kernels: " << acfKernelName()
+                << ", " << acfInt16KernelName() << Qt::endl;
+            return EXIT_SUCCESS;
+        }
+
+        int string = qBound(0, parser.value(stringOption).toInt(), NoteTable::nStrings-1);
+        worker.setDetector(parser.value(detectorOption).toInt());
+        worker.setDecimation(parser.value(rateOption).toInt());
+        worker.setThreshold(parser.value(thresholdOption).toDouble());
+        if(parser.isSet(noiseOffsetOption))
+            worker.setNoiseOffset(parser.value(noiseOffsetOption).toDouble());
+        worker.setCandidates(NoteTable::stringStart[string], NoteTable::stringStart[string]+NoteTable::nFrets);
+        if(parser.isSet(fastOption)) {
+            worker.setLowLatency(true);
+            worker.setTargetNote(parser.value(fastOption).toInt());
+        }
+
+        // Every result is printed with the stream time of the last write
+        qint64 samplesWritten = 0;
+        int nResults = 0;
+        QObject::connect(&worker, &DspWorker::resultReady, [&]() {
+            PitchEstimate estimate;
+            if(!worker.takeResult(&estimate))
+                return;
+            nResults++;
+            QString sNotes;
+            for(int i=0; i<estimate.nNotes; i++)
+                sNotes += (i > 0 ? "+" : "")+notes[estimate.notes[i]].name();
+            out << QString("%1 s  %2  %3 Hz  confidence %4")
+                       .arg(double(samplesWritten)/sampleRate, 9, 'f', 3)
+                       .arg(sNotes, -16)
+                       .arg(estimate.frequency, 8, 'f', 2)
+                       .arg(estimate.confidence, 0, 'f', 2)
+                << Qt::endl;
+        });
+
+        out << "# " << files.at(iFile) << " (" << sampleRate << " Hz, "
+            << wav.channels() << " channels) detector: "
+            << worker.detectorName(parser.value(detectorOption).toInt()) << Qt::endl;
+        const std::vector<int16_t>& samples = wav.samples();
+        int blockSamples = qMax(1, int(qint64(sampleRate)*parser.value(blockOption).toInt()/1000));
+        buffer.reserve(worker.maxWindowSamples()+blockSamples);
+        bool bRealtime = parser.isSet(realtimeOption);
+        buffer.open(QIODevice::WriteOnly);
+        worker.setActive(true);
+        int nBlocks = 0;
+        QElapsedTimer timer;
+        timer.start();
+        while(samplesWritten < qint64(samples.size())) {
+            int n = int(qMin(qint64(blockSamples), qint64(samples.size())-samplesWritten));
+            if(bRealtime) { // Wait until the block would have been captured
+                qint64 due = (samplesWritten+n)*1000/sampleRate;
+                qint64 wait = due-timer.elapsed();
+                if(wait > 0)
+                    QThread::msleep(quint64(wait));
+            }
+            buffer.write(reinterpret_cast<const char*>(samples.data()+samplesWritten),
+                         qint64(n)*qint64(sizeof(int16_t)));
+            samplesWritten += n;
+            nBlocks++;
+            QCoreApplication::processEvents(); // Runs the queued detection
+        }
+        worker.setActive(false);
+        buffer.close();
+
+        double seconds = qMax(1.0e-9, timer.nsecsElapsed()*1.0e-9);
+        double audioSeconds = double(samples.size())/sampleRate;
+        out << QString("# %1 blocks, %2 results in %3 s: %4 blocks/s (%5 x real time), %6 overruns")
+                   .arg(nBlocks)
+                   .arg(nResults)
+                   .arg(seconds, 0, 'f', 3)
+                   .arg(nBlocks/seconds, 0, 'f', 1)
+                   .arg(audioSeconds/seconds, 0, 'f', 1)
+                   .arg(buffer.overruns())
+            << Qt::endl;
+        if(parser.isSet(latencyOption))
+            out << latencyStats.report();
+    }
+    return exitCode;
+}
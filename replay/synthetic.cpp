@@ -0,0 +1,130 @@
+/*
+MIT License
+
+Copyright (c) 2022 salvato
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include "synthetic.h"
+
+#include <algorithm>
+#include <climits>
+#include <cmath>
+#include <random>
+
+
+std::vector<float>
+pluckedString(int sampleRate, const PluckParameters& parameters) {
+    std::mt19937 generator(parameters.seed);
+    std::uniform_real_distribution<float> uniform(-1.0f, 1.0f);
+    std::normal_distribution<float> gaussian(0.0f, 1.0f);
+
+    double frequency = parameters.frequency*std::pow(2.0, parameters.detuneCents/1200.0);
+    double loopDelay = sampleRate/frequency;
+    // Phase delays (at low frequency) of the filters in the loop
+    double a = -std::clamp(parameters.inharmonicity, 0.0, 0.5);
+    double dispersionDelay = (1.0-a)/(1.0+a);
+    double rest = loopDelay-0.5-dispersionDelay;
+    int nDelay = std::max(2, int(std::floor(rest-0.1)));
+    double fraction = rest-nDelay; // In [0.1, 1.1): a well behaved all pass
+    double c = (1.0-fraction)/(1.0+fraction);
+    // The fundamental of every note decays by 60dB in 4s
+    double loss = std::pow(0.001, 1.0/(4.0*frequency));
+
+    // The excitation: a noise burst with the high frequencies tamed
+    std::vector<float> line(nDelay);
+    float previous = 0.0f;
+    for(float& value : line) {
+        float noise = uniform(generator);
+        value = 0.5f*(noise+previous);
+        previous = noise;
+    }
+
+    int nSamples = int(parameters.seconds*sampleRate);
+    std::vector<float> x(nSamples);
+    float lastOut = 0.0f;
+    float dispersionIn = 0.0f, dispersionOut = 0.0f;
+    float tuningIn = 0.0f, tuningOut = 0.0f;
+    int position = 0;
+    for(int t=0; t<nSamples; t++) {
+        float out = line[position];
+        float average = 0.5f*(out+lastOut);
+        lastOut = out;
+        float dispersed = float(a)*average+dispersionIn-float(a)*dispersionOut;
+        dispersionIn  = average;
+        dispersionOut = dispersed;
+        float tuned = float(c)*dispersed+tuningIn-float(c)*tuningOut;
+        tuningIn  = dispersed;
+        tuningOut = tuned;
+        line[position] = float(loss)*tuned;
+        position = (position+1) % nDelay;
+        x[t] = out;
+    }
+    // Peaks at -6dB full scale, then the noise is added
+    float peak = 1.0e-9f;
+    for(float value : x)
+        peak = std::max(peak, std::fabs(value));
+    for(float& value : x)
+        value = 0.5f*value/peak+float(parameters.noiseLevel)*gaussian(generator);
+    return x;
+}
+
+
+int
+firstDetection(PitchDetector* pDetector, const std::vector<float>& x,
+               int hopSamples, int64_t* nProcessed) {
+    int nTotal = int(x.size());
+    *nProcessed = 0;
+    for(int end=hopSamples; end<=nTotal; end+=hopSamples) {
+        int nSamples = std::min(end, pDetector->windowSamples());
+        *nProcessed += hopSamples;
+        PitchEstimate estimate;
+        if(pDetector->process(x.data()+end-nSamples, nSamples, std::min(hopSamples, nSamples), &estimate))
+            return estimate.note;
+    }
+    return -1;
+}
+
+
+int
+firstDetection(PitchDetector* pDetector, const std::vector<int16_t>& x,
+               int hopSamples, int64_t* nProcessed) {
+    int nTotal = int(x.size());
+    *nProcessed = 0;
+    for(int end=hopSamples; end<=nTotal; end+=hopSamples) {
+        int nSamples = std::min(end, pDetector->windowSamples());
+        *nProcessed += hopSamples;
+        PitchEstimate estimate;
+        if(pDetector->processInt16(x.data()+end-nSamples, nSamples, std::min(hopSamples, nSamples), &estimate))
+            return estimate.note;
+    }
+    return -1;
+}
+
+
+std::vector<int16_t>
+toInt16(const std::vector<float>& x) {
+    std::vector<int16_t> samples(x.size());
+    for(size_t t=0; t<x.size(); t++) {
+        double value = std::round(double(x[t])*SHRT_MAX);
+        samples[t] = int16_t(std::clamp(value, -double(SHRT_MAX), double(SHRT_MAX)));
+    }
+    return samples;
+}
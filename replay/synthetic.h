@@ -0,0 +1,59 @@
+/*
+MIT License
+
+Copyright (c) 2022 salvato
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#pragma once
+
+#include "pitchdetector.h"
+#include <cstdint>
+#include <vector>
+
+
+// A plucked string (Karplus-Strong). The loop holds a two point average
+// (the losses), an all pass dispersion filter (the stiffness of the
+// string: its partials get sharper) and an all pass fractional delay
+// that keeps the fundamental in tune whatever the other two do.
+struct PluckParameters {
+    double frequency;      // Hz (before the detuning)
+    double inharmonicity;  // 0 (ideal string) to 0.5 (stiff)
+    double detuneCents;
+    double noiseLevel;     // RMS of the added white noise (full scale = 1)
+    double seconds;
+    uint32_t seed;
+};
+
+std::vector<float> pluckedString(int sampleRate, const PluckParameters& parameters);
+
+// Feeds x to the detector in blocks of hopSamples (as the audio backend
+// does with IOBuffer) and returns the first note reported, or -1.
+// nProcessed gets the number of samples examined.
+int firstDetection(PitchDetector* pDetector, const std::vector<float>& x,
+                   int hopSamples, int64_t* nProcessed);
+
+// The same through processInt16(), for the fixed point detectors
+int firstDetection(PitchDetector* pDetector, const std::vector<int16_t>& x,
+                   int hopSamples, int64_t* nProcessed);
+
+// The samples of the sound card: x scaled by SHRT_MAX, rounded and
+// clamped to [-SHRT_MAX, SHRT_MAX] (as acfCopyInt16() does)
+std::vector<int16_t> toInt16(const std::vector<float>& x);
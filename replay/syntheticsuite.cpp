@@ -0,0 +1,248 @@
+/*
+MIT License
+
+Copyright (c) 2022 salvato
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include "syntheticsuite.h"
+#include "synthetic.h"
+#include "dspworker.h"
+#include "acfkernel.h"
+
+#include <QtConcurrent>
+#include <QElapsedTimer>
+#include <memory>
+#include <random>
+
+
+static const char* stringName[NoteTable::nStrings] = {"E string", "A string", "D string",
+                                                       "G string", "B string", "e string"};
+using NoteTable::stringStart;
+using NoteTable::nFrets;
+using NoteTable::firstGuitarNote;
+using NoteTable::lastGuitarNote;
+
+
+struct Trial {
+    int note;
+    int variation;
+};
+
+
+struct Outcome {
+    int note;
+    int detected;
+    qint64 nSamples;
+};
+
+
+// The trials of one thread, and the time spent in the detector
+struct Batch {
+    QList<Trial> trials;
+    QList<Outcome> outcomes;
+    qint64 nanoseconds = 0;
+    int nMismatches = 0; // Of the fixed point and float decisions
+};
+
+
+// The plucked string of a trial
+static std::vector<float>
+trialSignal(const std::vector<Note>& notes, const SuiteOptions& options, const Trial& trial) {
+    uint32_t seed = uint32_t(trial.note*1000+trial.variation);
+    std::mt19937 generator(seed);
+    std::uniform_real_distribution<double> uniform(-1.0, 1.0);
+    PluckParameters parameters;
+    parameters.frequency     = notes[trial.note].frequency;
+    parameters.inharmonicity = options.inharmonicity;
+    parameters.detuneCents   = options.maxDetuneCents*uniform(generator);
+    parameters.noiseLevel    = options.noiseLevel;
+    parameters.seconds       = 1.0;
+    parameters.seed          = seed;
+    return pluckedString(options.sampleRate, parameters);
+}
+
+
+// One detector (not thread safe) runs all the trials of a thread.
+// Only the detection is timed: neither the synthesis of the
+// signals nor the construction of the detector (FFT plans, filter
+// banks) belong to the throughput of the detector.
+// The fixed point detectors get the int16 samples, as from the sound
+// card, and then (not timed) their float version the same samples.
+static void
+runBatch(const std::vector<Note>& notes, const SuiteOptions& options, int detector, Batch& batch) {
+    int window = DspWorker::defaultWindowSamples(options.sampleRate);
+    std::unique_ptr<PitchDetector> pDetector(DspWorker::newDetector(detector, notes, options.sampleRate, window));
+    int referenceProducts = window-int(double(options.sampleRate)/notes[0].frequency+0.5);
+    int nNotes = int(notes.size());
+    QElapsedTimer timer;
+    for(const Trial& trial : batch.trials) {
+        std::vector<float> x = trialSignal(notes, options, trial);
+        int first = qBound(0, trial.note-nFrets/2, nNotes-nFrets);
+        pDetector->reset();
+        pDetector->setCandidates(first, first+nFrets);
+        pDetector->setTargetNote(trial.note);
+        pDetector->setThreshold(options.threshold/referenceProducts);
+
+        Outcome outcome;
+        outcome.note = trial.note;
+        int64_t nProcessed = 0;
+        if(pDetector->acceptsInt16()) {
+            std::vector<int16_t> samples = toInt16(x);
+            timer.start();
+            outcome.detected = firstDetection(pDetector.get(), samples, window, &nProcessed);
+            batch.nanoseconds += timer.nsecsElapsed();
+            acfToFloat(samples.data(), int(samples.size()), x.data());
+            int64_t nFloat = 0;
+            pDetector->reset();
+            if(firstDetection(pDetector.get(), x, window, &nFloat) != outcome.detected)
+                batch.nMismatches++;
+        }
+        else {
+            timer.start();
+            outcome.detected = firstDetection(pDetector.get(), x, window, &nProcessed);
+            batch.nanoseconds += timer.nsecsElapsed();
+        }
+        outcome.nSamples = nProcessed;
+        batch.outcomes.append(outcome);
+    }
+}
+
+
+struct Tally {
+    int nTrials = 0;
+    int nCorrect = 0;
+    int nOctave = 0;
+    int nMissed = 0;
+    void add(const Outcome& outcome) {
+        nTrials++;
+        if(outcome.detected == outcome.note)
+            nCorrect++;
+        else if(outcome.detected < 0)
+            nMissed++;
+        else if((outcome.detected-outcome.note) % 12 == 0)
+            nOctave++;
+    }
+    double accuracy() const {
+        return nTrials > 0 ? 100.0*nCorrect/nTrials : 0.0;
+    }
+};
+
+
+static QString
+tallyLine(const QString& sName, const Tally& tally) {
+    return QString("%1 %2 %3 %4 %5 %6%\n")
+        .arg(sName, -16)
+        .arg(tally.nTrials, 7)
+        .arg(tally.nCorrect, 8)
+        .arg(tally.nOctave, 7)
+        .arg(tally.nMissed, 7)
+        .arg(tally.accuracy(), 8, 'f', 1);
+}
+
+
+SuiteResult
+runSyntheticSuite(const std::vector<Note>& notes, const SuiteOptions& options, QTextStream& out) {
+    QList<Trial> trials;
+    for(int note=0; note<int(notes.size()); note++)
+        for(int v=0; v<options.variations; v++)
+            trials.append({note, v});
+
+    int firstDetector = options.detector < 0 ? 0 : options.detector;
+    int lastDetector  = options.detector < 0 ? DspWorker::nDetectorKinds-1 : options.detector;
+    SuiteResult result;
+    result.worstAccuracy = 100.0;
+    result.nMismatches   = 0;
+    out << QString("# %1 notes x %2 variations at %3 Hz, inharmonicity %4, detune +/-%5 cents, noise %6 RMS, %7 threads\n")
+               .arg(int(notes.size()))
+               .arg(options.variations)
+               .arg(options.sampleRate)
+               .arg(options.inharmonicity)
+               .arg(options.maxDetuneCents)
+               .arg(options.noiseLevel)
+               .arg(QThreadPool::globalInstance()->maxThreadCount());
+    // The trials are dealt to the threads in turn, so that
+    // every thread gets some of the (slow) low notes
+    int nThreads = qMax(1, QThreadPool::globalInstance()->maxThreadCount());
+    for(int detector=firstDetector; detector<=lastDetector; detector++) {
+        QList<Batch> batches(nThreads);
+        for(int i=0; i<trials.count(); i++)
+            batches[i % nThreads].trials.append(trials.at(i));
+        QtConcurrent::blockingMap(batches, [&](Batch& batch) {
+            runBatch(notes, options, detector, batch);
+        });
+        QList<Outcome> outcomes;
+        qint64 nanoseconds = 0;
+        int nMismatches = 0;
+        for(const Batch& batch : batches) {
+            outcomes += batch.outcomes;
+            nanoseconds += batch.nanoseconds;
+            nMismatches += batch.nMismatches;
+        }
+        double seconds = qMax(1.0e-9, nanoseconds*1.0e-9); // Of one thread
+
+        Tally strings[NoteTable::nStrings];
+        Tally guitar;
+        Tally all;
+        qint64 nSamples = 0;
+        QStringList failures;
+        for(const Outcome& outcome : outcomes) {
+            nSamples += outcome.nSamples;
+            all.add(outcome);
+            for(int s=0; s<NoteTable::nStrings; s++)
+                if(outcome.note >= stringStart[s] && outcome.note < stringStart[s]+nFrets)
+                    strings[s].add(outcome);
+            if(outcome.note < firstGuitarNote || outcome.note > lastGuitarNote)
+                continue;
+            guitar.add(outcome);
+            if(outcome.detected != outcome.note)
+                failures << QString("%1->%2").arg(notes[outcome.note].name(),
+                                                 outcome.detected < 0 ? QString("none") : notes[outcome.detected].name());
+        }
+
+        std::unique_ptr<PitchDetector> pDetector(DspWorker::newDetector(detector, notes, options.sampleRate,
+                                                                            DspWorker::defaultWindowSamples(options.sampleRate)));
+        out << "\n# Detector " << detector << ": " << pDetector->name() << "\n";
+        out << QString("%1 %2 %3 %4 %5 %6\n")
+                   .arg("Notes", -16)
+                   .arg("Trials", 7)
+                   .arg("Correct", 8)
+                   .arg("Octave", 7)
+                   .arg("Missed", 7)
+                   .arg("Accuracy", 9);
+        for(int s=0; s<NoteTable::nStrings; s++)
+            out << tallyLine(stringName[s], strings[s]);
+        out << tallyLine("Guitar (E2-E5)", guitar);
+        out << tallyLine("Whole table", all);
+        out << QString("%1 samples/s per thread (%2 x real time)\n")
+                   .arg(nSamples/seconds, 0, 'g', 4)
+                   .arg(nSamples/seconds/options.sampleRate, 0, 'f', 0);
+        if(pDetector->acceptsInt16())
+            out << QString("Fixed point vs float decisions: %1 of %2 differ\n")
+                       .arg(nMismatches)
+                       .arg(int(outcomes.count()));
+        if(!failures.isEmpty())
+            out << "Failures: " << failures.join(' ') << "\n";
+        result.worstAccuracy = qMin(result.worstAccuracy, guitar.accuracy());
+        result.nMismatches  += nMismatches;
+    }
+    out.flush();
+    return result;
+}
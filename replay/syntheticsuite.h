@@ -0,0 +1,53 @@
+/*
+MIT License
+
+Copyright (c) 2022 salvato
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#pragma once
+
+#include "note.h"
+#include <QTextStream>
+#include <vector>
+
+
+// Accuracy and throughput regression suite: every note of the table is
+// synthesized (plucked string) a few times, with random detuning, and
+// given to the detectors. All the trials run in parallel on every core.
+struct SuiteOptions {
+    int detector;          // Index of DspWorker::newDetector(), -1 for all
+    int sampleRate;
+    int variations;        // Trials per note
+    double inharmonicity;  // See PluckParameters
+    double maxDetuneCents;
+    double noiseLevel;
+    double threshold;      // As DspWorker::setThreshold()
+};
+
+struct SuiteResult {
+    double worstAccuracy;  // The lowest (%) on the guitar range (E2 to E5) among the detectors run
+    int nMismatches;       // Trials where the fixed point detectors decided
+                           // otherwise than their float version
+};
+
+// Prints the report. The fixed point detectors run on the int16 samples
+// and are also compared with their float version on the same samples.
+SuiteResult runSyntheticSuite(const std::vector<Note>& notes, const SuiteOptions& options, QTextStream& out);
@@ -0,0 +1,140 @@
+/*
+MIT License
+
+Copyright (c) 2022 salvato
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include "wavreader.h"
+
+#include <QFile>
+#include <QtEndian>
+#include <cmath>
+#include <cstring>
+
+
+WavReader::WavReader()
+    : rate(0)
+    , nChannels(0)
+{
+}
+
+
+QString
+WavReader::errorString() const {
+    return sError;
+}
+
+
+int
+WavReader::sampleRate() const {
+    return rate;
+}
+
+
+int
+WavReader::channels() const {
+    return nChannels;
+}
+
+
+const std::vector<int16_t>&
+WavReader::samples() const {
+    return data;
+}
+
+
+// One sample of any supported format, scaled to [-1, 1)
+static double
+decodeSample(const uchar* p, int format, int bits) {
+    if(format == 3) { // IEEE float
+        quint32 bitPattern = qFromLittleEndian<quint32>(p);
+        float value;
+        memcpy(&value, &bitPattern, sizeof(value));
+        return double(value);
+    }
+    switch(bits) {
+        case 8:
+            return (int(p[0])-128)/128.0;
+        case 16:
+            return qFromLittleEndian<qint16>(p)/32768.0;
+        case 24:
+            return (qint32(quint32(p[0]) << 8 | quint32(p[1]) << 16 | quint32(p[2]) << 24) >> 8)/8388608.0;
+        default:
+            return qFromLittleEndian<qint32>(p)/2147483648.0;
+    }
+}
+
+
+bool
+WavReader::load(const QString& fileName) {
+    data.clear();
+    QFile file(fileName);
+    if(!file.open(QIODevice::ReadOnly)) {
+        sError = file.errorString();
+        return false;
+    }
+    QByteArray bytes = file.readAll();
+    const uchar* p = reinterpret_cast<const uchar*>(bytes.constData());
+    qint64 size = bytes.size();
+    if(size < 12 || memcmp(p, "RIFF", 4) != 0 || memcmp(p+8, "WAVE", 4) != 0) {
+        sError = "Not a RIFF/WAVE file";
+        return false;
+    }
+    int format = 0;
+    int bits = 0;
+    const uchar* pSamples = nullptr;
+    qint64 nBytes = 0;
+    qint64 position = 12;
+    while(position+8 <= size) {
+        const uchar* pChunk = p+position;
+        qint64 chunkSize = qFromLittleEndian<quint32>(pChunk+4);
+        qint64 available = qMin(chunkSize, size-position-8);
+        if(memcmp(pChunk, "fmt ", 4) == 0 && available >= 16) {
+            format    = qFromLittleEndian<quint16>(pChunk+8);
+            nChannels = qFromLittleEndian<quint16>(pChunk+10);
+            rate      = int(qFromLittleEndian<quint32>(pChunk+12));
+            bits      = qFromLittleEndian<quint16>(pChunk+22);
+            if(format == 0xFFFE && available >= 26) // WAVE_FORMAT_EXTENSIBLE: the subformat GUID starts with the format
+                format = qFromLittleEndian<quint16>(pChunk+32);
+        }
+        else if(memcmp(pChunk, "data", 4) == 0) {
+            pSamples = pChunk+8;
+            nBytes   = available;
+        }
+        position += 8+chunkSize+(chunkSize & 1); // Chunks are word aligned
+    }
+    bool bSupported = (format == 1 && (bits == 8 || bits == 16 || bits == 24 || bits == 32)) ||
+                      (format == 3 && bits == 32);
+    if(!bSupported || nChannels < 1 || rate <= 0 || !pSamples) {
+        sError = QString("Unsupported WAVE format (format %1, %2 bits)").arg(format).arg(bits);
+        return false;
+    }
+    int frameBytes = nChannels*bits/8;
+    qint64 nFrames = nBytes/frameBytes;
+    data.resize(size_t(nFrames));
+    for(qint64 i=0; i<nFrames; i++) {
+        double sum = 0.0;
+        for(int c=0; c<nChannels; c++)
+            sum += decodeSample(pSamples+i*frameBytes+c*bits/8, format, bits);
+        data[size_t(i)] = qint16(qBound(-32768.0, std::floor(sum/nChannels*32768.0+0.5), 32767.0));
+    }
+    return true;
+}
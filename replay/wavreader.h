@@ -24,26 +24,26 @@ SOFTWARE.
 
 #pragma once
 
-#include <QIODevice>
-#include <QObject>
+#include <QString>
+#include <vector>
+#include <cstdint>
 
-class IOBuffer : public QIODevice
+
+// Loads a whole RIFF/WAVE file (PCM 8, 16, 24 or 32 bit, or 32 bit float)
+// and mixes it down to mono int16 samples, the format of IOBuffer.
+class WavReader
 {
-    Q_OBJECT
 public:
-    explicit IOBuffer(char *buffer, int sampleNumber, QObject *parent = nullptr);
-    ~IOBuffer();
-
-signals:
-    void bufferFull();
-
-protected:
-    qint64 readData(char* pData, qint64 dataSize) override;
-    qint64 writeData(const char* pData, qint64 dataSize) override;
+    WavReader();
+    bool load(const QString& fileName);
+    QString errorString() const;
+    int sampleRate() const;
+    int channels() const;
+    const std::vector<int16_t>& samples() const;
 
 private:
-    char* pBuffer;
-    int sampleCount;
-    int bufferStart;
+    QString sError;
+    int rate;
+    int nChannels;
+    std::vector<int16_t> data;
 };
-
@@ -0,0 +1,122 @@
+/*
+MIT License
+
+Copyright (c) 2022 salvato
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+// Stand-in client of NoteDaemon: replays a WAV file on one or more
+// concurrent streams and reports the detections and the throughput.
+
+#include "streamclient.h"
+#include "wavreader.h"
+#include "protocol.h"
+
+#include <QCoreApplication>
+#include <QCommandLineParser>
+#include <QElapsedTimer>
+#include <QTextStream>
+#include <memory>
+
+
+int
+main(int argc, char *argv[]) {
+    QCoreApplication::setOrganizationDomain("Gabriele.Salvato");
+    QCoreApplication::setOrganizationName("Gabriele.Salvato");
+    QCoreApplication::setApplicationName("NoteStream");
+    QCoreApplication::setApplicationVersion("0.0.1");
+    QCoreApplication app(argc, argv);
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Streams a WAV file to NoteDaemon");
+    parser.addHelpOption();
+    parser.addVersionOption();
+    parser.addPositionalArgument("file", "WAV file to stream", "file.wav");
+    QCommandLineOption socketOption("socket", "Name (or path) of the local socket.", "name", Protocol::defaultSocketName);
+    QCommandLineOption detectorOption({"d", "detector"}, "Detector index (see NoteReplay --list).", "index", "0");
+    QCommandLineOption rateOption({"r", "decimation"}, "Decimation factor: 1, 2 or 4.", "factor", "1");
+    QCommandLineOption blockOption({"b", "block"}, "Duration of every frame (ms).", "ms", "150");
+    QCommandLineOption stringOption({"s", "string"}, "Candidate string: 0 (low E) to 5 (high e).", "string", "0");
+    QCommandLineOption thresholdOption({"t", "threshold"}, "Fixed detection threshold.", "value", "5");
+    QCommandLineOption noiseOffsetOption("noise-offset", "Follow the noise floor, opening the gate this far above it.", "dB");
+    QCommandLineOption streamsOption({"n", "streams"}, "Concurrent streams of the same file.", "n", "1");
+    QCommandLineOption realtimeOption("realtime", "Send the frames in real time instead of as fast as possible.");
+    QCommandLineOption quietOption({"q", "quiet"}, "Print only the summary.");
+    parser.addOptions({socketOption, detectorOption, rateOption, blockOption, stringOption,
+                       thresholdOption, noiseOffsetOption, streamsOption, realtimeOption, quietOption});
+    parser.process(app);
+
+    QTextStream out(stdout);
+    QTextStream err(stderr);
+    if(parser.positionalArguments().count() != 1)
+        parser.showHelp(EXIT_FAILURE);
+    WavReader wav;
+    if(!wav.load(parser.positionalArguments().first())) {
+        err << parser.positionalArguments().first() << ": " << wav.errorString() << Qt::endl;
+        return EXIT_FAILURE;
+    }
+
+    QByteArray header = QString("%1 rate=%2 detector=%3 decimation=%4 string=%5 threshold=%6")
+                            .arg(QString::fromLatin1(Protocol::magic))
+                            .arg(wav.sampleRate())
+                            .arg(parser.value(detectorOption).toInt())
+                            .arg(parser.value(rateOption).toInt())
+                            .arg(parser.value(stringOption).toInt())
+                            .arg(parser.value(thresholdOption).toDouble())
+                            .toUtf8();
+    if(parser.isSet(noiseOffsetOption))
+        header += " offset="+QByteArray::number(parser.value(noiseOffsetOption).toDouble());
+
+    int nStreams = qMax(1, parser.value(streamsOption).toInt());
+    int blockSamples = qMax(1, int(qint64(wav.sampleRate())*parser.value(blockOption).toInt()/1000));
+    blockSamples = qMin(blockSamples, int(Protocol::maxFrameBytes/sizeof(int16_t)));
+    std::vector<std::unique_ptr<StreamClient>> clients;
+    int nRunning = nStreams;
+    QElapsedTimer timer;
+    timer.start();
+    for(int i=0; i<nStreams; i++) {
+        clients.emplace_back(new StreamClient(i, wav.samples(), wav.sampleRate(), blockSamples,
+                                              parser.isSet(realtimeOption),
+                                              parser.isSet(quietOption) ? nullptr : &out));
+        QObject::connect(clients.back().get(), &StreamClient::finished, [&]() {
+            if(--nRunning == 0)
+                app.quit();
+        });
+        clients.back()->start(parser.value(socketOption), header);
+    }
+    app.exec();
+
+    double seconds = qMax(1.0e-9, timer.nsecsElapsed()*1.0e-9);
+    double audioSeconds = double(wav.samples().size())/wav.sampleRate();
+    int nOk = 0;
+    int nDetections = 0;
+    for(const std::unique_ptr<StreamClient>& pClient : clients) {
+        nOk += pClient->isOk() ? 1 : 0;
+        nDetections += pClient->detections();
+    }
+    out << QString("# %1 of %2 streams completed, %3 detections in %4 s (%5 x real time in total)")
+               .arg(nOk)
+               .arg(nStreams)
+               .arg(nDetections)
+               .arg(seconds, 0, 'f', 3)
+               .arg(nOk*audioSeconds/seconds, 0, 'f', 1)
+        << Qt::endl;
+    return nOk == nStreams ? EXIT_SUCCESS : EXIT_FAILURE;
+}
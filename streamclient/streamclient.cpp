@@ -0,0 +1,152 @@
+/*
+MIT License
+
+Copyright (c) 2022 salvato
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include "streamclient.h"
+
+#include <QtEndian>
+
+
+StreamClient::StreamClient(int streamId, const std::vector<int16_t>& samples,
+                           int sampleRate, int blockSamples, bool bRealtime,
+                           QTextStream* pOutput, QObject* parent)
+    : QObject(parent)
+    , id(streamId)
+    , data(samples)
+    , rate(sampleRate)
+    , blockSize(blockSamples)
+    , bPaced(bRealtime)
+    , pOut(pOutput)
+    , nSent(0)
+    , nDetections(0)
+    , bEnded(false)
+    , bDone(false)
+    , bFinished(false)
+{
+    connect(&socket, SIGNAL(connected()),
+            this, SLOT(onConnected()));
+    connect(&socket, SIGNAL(readyRead()),
+            this, SLOT(onReadyRead()));
+    connect(&socket, SIGNAL(disconnected()),
+            this, SLOT(onDisconnected()));
+    connect(&socket, SIGNAL(errorOccurred(QLocalSocket::LocalSocketError)),
+            this, SLOT(onErrorOccurred(QLocalSocket::LocalSocketError)));
+    frameTimer.setTimerType(Qt::PreciseTimer);
+    connect(&frameTimer, SIGNAL(timeout()),
+            this, SLOT(sendFrame()));
+}
+
+
+void
+StreamClient::start(const QString& sSocketName, const QByteArray& header) {
+    streamHeader = header;
+    socket.connectToServer(sSocketName);
+}
+
+
+// True when the daemon has confirmed the end of the stream
+bool
+StreamClient::isOk() const {
+    return bEnded;
+}
+
+
+int
+StreamClient::detections() const {
+    return nDetections;
+}
+
+
+// As fast as possible every frame is queued at once:
+// the daemon reads them as its detector gets free
+void
+StreamClient::onConnected() {
+    socket.write(streamHeader+"\n");
+    if(bPaced) {
+        frameTimer.start(qMax(1, int(qint64(blockSize)*1000/rate)));
+        return;
+    }
+    while(!bDone)
+        sendFrame();
+}
+
+
+// The frame of size zero ends the stream
+void
+StreamClient::sendFrame() {
+    if(bDone)
+        return;
+    int n = int(qMin(qint64(blockSize), qint64(data.size())-nSent));
+    char size[sizeof(quint32)];
+    qToLittleEndian<quint32>(quint32(n*int(sizeof(int16_t))), size);
+    socket.write(size, sizeof(size));
+    if(n == 0) {
+        bDone = true;
+        frameTimer.stop();
+        return;
+    }
+    socket.write(reinterpret_cast<const char*>(data.data()+nSent), qint64(n)*qint64(sizeof(int16_t)));
+    nSent += n;
+}
+
+
+void
+StreamClient::onReadyRead() {
+    while(socket.canReadLine()) {
+        QString sLine = QString::fromUtf8(socket.readLine()).trimmed();
+        if(sLine.startsWith("note "))
+            nDetections++;
+        else if(sLine.startsWith("end "))
+            bEnded = true;
+        if(pOut)
+            *pOut << "[" << id << "] " << sLine << Qt::endl;
+    }
+}
+
+
+void
+StreamClient::onDisconnected() {
+    onReadyRead();
+    finish();
+}
+
+
+void
+StreamClient::finish() {
+    frameTimer.stop();
+    if(!bFinished) {
+        bFinished = true;
+        emit finished();
+    }
+}
+
+
+void
+StreamClient::onErrorOccurred(QLocalSocket::LocalSocketError socketError) {
+    if(socketError == QLocalSocket::PeerClosedError)
+        return;
+    if(pOut)
+        *pOut << "[" << id << "] " << socket.errorString() << Qt::endl;
+    if(socket.state() == QLocalSocket::UnconnectedState)
+        finish();
+}
@@ -0,0 +1,77 @@
+/*
+MIT License
+
+Copyright (c) 2022 salvato
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#pragma once
+
+#include <QObject>
+#include <QLocalSocket>
+#include <QTimer>
+#include <QTextStream>
+#include <vector>
+#include <cstdint>
+
+
+// One stream to NoteDaemon: the samples are sent in frames of
+// blockSamples (paced by the clock in real time mode) and the
+// note events of the daemon are printed as they arrive.
+class StreamClient : public QObject
+{
+    Q_OBJECT
+public:
+    StreamClient(int streamId, const std::vector<int16_t>& samples,
+                 int sampleRate, int blockSamples, bool bRealtime,
+                 QTextStream* pOutput, QObject* parent = nullptr);
+    void start(const QString& sSocketName, const QByteArray& header);
+    bool isOk() const;
+    int detections() const;
+
+signals:
+    void finished();
+
+private slots:
+    void onConnected();
+    void onReadyRead();
+    void onDisconnected();
+    void onErrorOccurred(QLocalSocket::LocalSocketError socketError);
+    void sendFrame();
+
+protected:
+    void finish();
+
+private:
+    int id;
+    const std::vector<int16_t>& data;
+    int rate;
+    int blockSize;
+    bool bPaced;
+    QTextStream* pOut;
+    QLocalSocket socket;
+    QTimer frameTimer;
+    QByteArray streamHeader;
+    qint64 nSent;
+    int nDetections;
+    bool bEnded;
+    bool bDone;     // Every frame has been sent
+    bool bFinished; // finished() has been emitted
+};